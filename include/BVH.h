@@ -0,0 +1,62 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "VulkanRenderer.h"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+// Flat BVH node matching the std430 layout used by the compute shader.
+// Nodes are emitted depth-first, so an interior node's left child is always
+// the node immediately following it; leftFirst holds the right child index
+// and primCount == 0. Leaf nodes store the first entry of the primitive
+// index list in leftFirst and the number of primitives in primCount.
+struct GPUBVHNode {
+  glm::vec3 aabbMin;
+  int32_t leftFirst;
+  glm::vec3 aabbMax;
+  int32_t primCount;
+};
+
+// Primitive indices referenced by leaf nodes. Spheres are stored as their
+// plain index; ellipsoids have the high bit set and triangles the next bit
+// down so the shader can dispatch to the correct intersection routine.
+constexpr uint32_t BVH_PRIM_ELLIPSOID_BIT = 0x80000000u;
+constexpr uint32_t BVH_PRIM_TRIANGLE_BIT = 0x40000000u;
+
+// CPU-side BVH builder over the combined sphere + ellipsoid + triangle
+// primitive list. Built once per scene update and uploaded as storage
+// buffers alongside the primitive buffers; the compute shader traverses it
+// with a small stack instead of walking every primitive linearly.
+class BVH {
+public:
+  // Rebuild the hierarchy from scratch. Median-split over the longest axis;
+  // cheap enough to run per-frame for animated scenes.
+  void build(const std::vector<GPUSphere> &spheres,
+             const std::vector<GPUEllipsoid> &ellipsoids,
+             const std::vector<GPUTriangle> &triangles =
+                 std::vector<GPUTriangle>());
+
+  const std::vector<GPUBVHNode> &getNodes() const noexcept { return nodes_; }
+  const std::vector<uint32_t> &getPrimitiveIndices() const noexcept {
+    return primIndices_;
+  }
+
+private:
+  // Working data for one primitive during construction
+  struct BuildPrim {
+    glm::vec3 aabbMin;
+    glm::vec3 aabbMax;
+    glm::vec3 centroid;
+    uint32_t encodedIndex; // sphere index, or ellipsoid index | ELLIPSOID_BIT
+  };
+
+  // Recursively split prims[first..first+count) and emit nodes
+  int32_t buildRecursive(std::vector<BuildPrim> &prims, int32_t first,
+                         int32_t count);
+
+  std::vector<GPUBVHNode> nodes_;
+  std::vector<uint32_t> primIndices_;
+};
+
+#endif // BVH_H
@@ -0,0 +1,55 @@
+#ifndef CPU_RENDERER_H
+#define CPU_RENDERER_H
+
+#include "Camera.h"
+#include "VulkanRenderer.h"
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// CPU fallback engine: traces the same GPU-format scene when
+// VulkanRenderer::initialize fails (no Vulkan loader, no capable device).
+// Frames are rendered with TBB tile-based work stealing - a parallel_for
+// over screen tiles with per-thread hit-record arenas - and come back as
+// RGBA8 pixels ready for a software blit or the batch PPM writer.
+//
+// Shading mirrors the compute shader's Phong path (ambient + shadowed
+// Blinn-Phong per light, emissive, reflectivity bounces, volume march,
+// background gradient); custom surface shaders fall back to plain Phong
+// since there is no GPU pipeline to compile them into.
+class CpuRenderer {
+public:
+  CpuRenderer(int width, int height);
+  ~CpuRenderer();
+
+  // Scene setup from the same GPU-format arrays fed to VulkanRenderer
+  void setScene(const std::vector<GPUSphere> &spheres,
+                const std::vector<GPUEllipsoid> &ellipsoids,
+                const std::vector<GPUMaterial> &materials,
+                const std::vector<GPULight> &lights);
+
+  // Per-frame ellipsoid animation update (matches
+  // VulkanRenderer::updateEllipsoids)
+  void updateEllipsoids(const std::vector<GPUEllipsoid> &ellipsoids);
+
+  // Loads the volume from its .dat/.raw files; the GPU density atlas does
+  // not exist on this path, so the CPU engine keeps its own copy
+  bool addVolume(const std::string &datFile, const std::string &rawFile,
+                 const glm::vec3 &position, float scale, int materialIndex);
+
+  // Renders one frame into outPixels (RGBA8, width*height*4, row 0 at the
+  // top to match the GPU output)
+  void render(const Camera &camera, const PushConstants &pushConstants,
+              std::vector<uint8_t> &outPixels);
+
+private:
+  // The legacy CPU object classes (Sphere, Material, Light) collide with
+  // the SceneWrappers names, so the implementation hides them behind a
+  // pimpl; this header stays safe to include next to SceneWrappers.h
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+#endif // CPU_RENDERER_H
@@ -3,6 +3,9 @@
 
 #include "Vec3.h"
 
+#include <cmath>
+#include <stdexcept>
+
 /**
  * @class Quaternion
  * @brief Represents a quaternion for rotation operations
@@ -10,15 +13,35 @@
  * A quaternion is represented as q = w + xi + yj + zk, where w is the scalar
  * part and (x, y, z) is the vector part. This class provides operations for
  * creating, manipulating, and applying quaternion rotations to 3D vectors.
+ *
+ * The implementation is header-only single-precision over the same 4-lane
+ * SIMD representation as Vec3 (lanes x, y, z, w), so the per-frame
+ * fromAxisAngle / rotateVector path in the animation loop inlines fully.
+ * Elementwise operations run on the whole register; the Hamilton product and
+ * the matrix/Euler conversions stay scalar, where shuffling costs more than
+ * it saves.
  */
-class Quaternion {
+class alignas(16) Quaternion {
 public:
-  double w, x, y, z; // w is the scalar part, (x,y,z) is the vector part
+  union {
+#if defined(VEC_MATH_SSE)
+    __m128 v;
+#elif defined(VEC_MATH_NEON)
+    float32x4_t v;
+#endif
+    struct {
+      float x, y, z, w; // w is the scalar part, (x,y,z) is the vector part
+    };
+  };
 
   /**
    * @brief Default constructor - creates identity quaternion (1, 0, 0, 0)
    */
-  Quaternion();
+#if defined(VEC_MATH_SSE)
+  Quaternion() : v(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f)) {}
+#else
+  Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+#endif
 
   /**
    * @brief Constructor from components
@@ -27,7 +50,19 @@ public:
    * @param y Y component of vector part
    * @param z Z component of vector part
    */
-  Quaternion(double w, double x, double y, double z);
+#if defined(VEC_MATH_SSE)
+  Quaternion(float w, float x, float y, float z)
+      : v(_mm_set_ps(w, z, y, x)) {}
+  explicit Quaternion(__m128 raw) : v(raw) {}
+#elif defined(VEC_MATH_NEON)
+  Quaternion(float w, float x, float y, float z) {
+    float lanes[4] = {x, y, z, w};
+    v = vld1q_f32(lanes);
+  }
+  explicit Quaternion(float32x4_t raw) : v(raw) {}
+#else
+  Quaternion(float w, float x, float y, float z) : x(x), y(y), z(z), w(w) {}
+#endif
 
   /**
    * @brief Create a quaternion from axis-angle representation
@@ -35,7 +70,16 @@ public:
    * @param angleRadians Rotation angle in radians
    * @return Quaternion representing the rotation
    */
-  static Quaternion fromAxisAngle(const Vec3 &axis, double angleRadians);
+  static Quaternion fromAxisAngle(const Vec3 &axis, float angleRadians) {
+    Vec3 normalizedAxis = axis.normalized();
+    float halfAngle = angleRadians * 0.5f;
+    float sinHalfAngle = std::sin(halfAngle);
+    float cosHalfAngle = std::cos(halfAngle);
+
+    return Quaternion(cosHalfAngle, normalizedAxis.x * sinHalfAngle,
+                      normalizedAxis.y * sinHalfAngle,
+                      normalizedAxis.z * sinHalfAngle);
+  }
 
   /**
    * @brief Create a quaternion from Euler angles (ZYX convention)
@@ -44,7 +88,19 @@ public:
    * @param yaw Rotation around Z axis in radians
    * @return Quaternion representing the combined rotation
    */
-  static Quaternion fromEulerAngles(double roll, double pitch, double yaw);
+  static Quaternion fromEulerAngles(float roll, float pitch, float yaw) {
+    float cy = std::cos(yaw * 0.5f);
+    float sy = std::sin(yaw * 0.5f);
+    float cp = std::cos(pitch * 0.5f);
+    float sp = std::sin(pitch * 0.5f);
+    float cr = std::cos(roll * 0.5f);
+    float sr = std::sin(roll * 0.5f);
+
+    return Quaternion(cr * cp * cy + sr * sp * sy,
+                      sr * cp * cy - cr * sp * sy,
+                      cr * sp * cy + sr * cp * sy,
+                      cr * cp * sy - sr * sp * cy);
+  }
 
   /**
    * @brief Create a quaternion from a rotation matrix
@@ -59,88 +115,182 @@ public:
    * @param m22 Matrix element [2][2]
    * @return Quaternion representing the rotation
    */
-  static Quaternion fromRotationMatrix(double m00, double m01, double m02,
-                                       double m10, double m11, double m12,
-                                       double m20, double m21, double m22);
+  static Quaternion fromRotationMatrix(float m00, float m01, float m02,
+                                       float m10, float m11, float m12,
+                                       float m20, float m21, float m22) {
+    float trace = m00 + m11 + m22;
+
+    if (trace > 0.0f) {
+      float s = 0.5f / std::sqrt(trace + 1.0f);
+      return Quaternion(0.25f / s, (m21 - m12) * s, (m02 - m20) * s,
+                        (m10 - m01) * s);
+    } else if (m00 > m11 && m00 > m22) {
+      float s = 2.0f * std::sqrt(1.0f + m00 - m11 - m22);
+      return Quaternion((m21 - m12) / s, 0.25f * s, (m01 + m10) / s,
+                        (m02 + m20) / s);
+    } else if (m11 > m22) {
+      float s = 2.0f * std::sqrt(1.0f + m11 - m00 - m22);
+      return Quaternion((m02 - m20) / s, (m01 + m10) / s, 0.25f * s,
+                        (m12 + m21) / s);
+    } else {
+      float s = 2.0f * std::sqrt(1.0f + m22 - m00 - m11);
+      return Quaternion((m10 - m01) / s, (m02 + m20) / s, (m12 + m21) / s,
+                        0.25f * s);
+    }
+  }
 
   // Quaternion operations
   /**
    * @brief Quaternion addition
    */
-  Quaternion operator+(const Quaternion &q) const;
+  Quaternion operator+(const Quaternion &q) const {
+#if defined(VEC_MATH_SSE)
+    return Quaternion(_mm_add_ps(v, q.v));
+#elif defined(VEC_MATH_NEON)
+    return Quaternion(vaddq_f32(v, q.v));
+#else
+    return Quaternion(w + q.w, x + q.x, y + q.y, z + q.z);
+#endif
+  }
 
   /**
    * @brief Quaternion subtraction
    */
-  Quaternion operator-(const Quaternion &q) const;
+  Quaternion operator-(const Quaternion &q) const {
+#if defined(VEC_MATH_SSE)
+    return Quaternion(_mm_sub_ps(v, q.v));
+#elif defined(VEC_MATH_NEON)
+    return Quaternion(vsubq_f32(v, q.v));
+#else
+    return Quaternion(w - q.w, x - q.x, y - q.y, z - q.z);
+#endif
+  }
 
   /**
    * @brief Quaternion multiplication (Hamilton product)
    */
-  Quaternion operator*(const Quaternion &q) const;
+  Quaternion operator*(const Quaternion &q) const {
+    return Quaternion(w * q.w - x * q.x - y * q.y - z * q.z,
+                      w * q.x + x * q.w + y * q.z - z * q.y,
+                      w * q.y - x * q.z + y * q.w + z * q.x,
+                      w * q.z + x * q.y - y * q.x + z * q.w);
+  }
 
   /**
    * @brief Scalar multiplication
    */
-  Quaternion operator*(double scalar) const;
+  Quaternion operator*(float scalar) const {
+#if defined(VEC_MATH_SSE)
+    return Quaternion(_mm_mul_ps(v, _mm_set1_ps(scalar)));
+#elif defined(VEC_MATH_NEON)
+    return Quaternion(vmulq_n_f32(v, scalar));
+#else
+    return Quaternion(w * scalar, x * scalar, y * scalar, z * scalar);
+#endif
+  }
 
   /**
    * @brief Scalar division
    */
-  Quaternion operator/(double scalar) const;
+  Quaternion operator/(float scalar) const {
+    if (scalar == 0.0f) {
+      throw std::invalid_argument("Division by zero");
+    }
+    return *this * (1.0f / scalar);
+  }
 
   /**
    * @brief Compound addition
    */
-  Quaternion &operator+=(const Quaternion &q);
+  Quaternion &operator+=(const Quaternion &q) {
+    *this = *this + q;
+    return *this;
+  }
 
   /**
    * @brief Compound multiplication
    */
-  Quaternion &operator*=(const Quaternion &q);
+  Quaternion &operator*=(const Quaternion &q) {
+    *this = *this * q;
+    return *this;
+  }
 
   /**
    * @brief Compound scalar multiplication
    */
-  Quaternion &operator*=(double scalar);
+  Quaternion &operator*=(float scalar) {
+    *this = *this * scalar;
+    return *this;
+  }
 
   /**
    * @brief Compute the magnitude (norm) of the quaternion
    */
-  double magnitude() const;
+  float magnitude() const { return std::sqrt(magnitudeSquared()); }
 
   /**
    * @brief Compute the squared magnitude
    */
-  double magnitudeSquared() const;
+  float magnitudeSquared() const { return dot(*this, *this); }
 
   /**
    * @brief Normalize the quaternion to unit length
    * @return Reference to this quaternion after normalization
    */
-  Quaternion &normalize();
+  Quaternion &normalize() {
+    float mag = magnitude();
+    if (mag > 0.0f) {
+      *this *= 1.0f / mag;
+    }
+    return *this;
+  }
 
   /**
    * @brief Get a normalized copy of this quaternion
    */
-  Quaternion normalized() const;
+  Quaternion normalized() const {
+    Quaternion q = *this;
+    q.normalize();
+    return q;
+  }
 
   /**
    * @brief Compute the conjugate of the quaternion (w, -x, -y, -z)
    */
-  Quaternion conjugate() const;
+  Quaternion conjugate() const {
+#if defined(VEC_MATH_SSE)
+    // Flip the sign of the vector lanes only
+    return Quaternion(
+        _mm_xor_ps(v, _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f)));
+#else
+    return Quaternion(w, -x, -y, -z);
+#endif
+  }
 
   /**
    * @brief Compute the inverse of the quaternion
    */
-  Quaternion inverse() const;
+  Quaternion inverse() const {
+    float magSq = magnitudeSquared();
+    if (magSq == 0.0f) {
+      throw std::invalid_argument("Cannot invert a zero quaternion");
+    }
+    return conjugate() / magSq;
+  }
 
   /**
    * @brief Rotate a 3D vector by this quaternion
    * @param v Vector to rotate
    * @return Rotated vector
+   *
+   * Uses the expanded form v' = v + 2w(qv x v) + 2(qv x (qv x v)), which
+   * stays in Vec3 SIMD ops instead of two Hamilton products.
    */
-  Vec3 rotateVector(const Vec3 &v) const;
+  Vec3 rotateVector(const Vec3 &vec) const {
+    Vec3 qv(x, y, z);
+    Vec3 t = qv.cross(vec) * 2.0f;
+    return vec + t * w + qv.cross(t);
+  }
 
   /**
    * @brief Linear interpolation between two quaternions
@@ -149,7 +299,24 @@ public:
    * @param t Interpolation parameter (0 to 1)
    * @return Interpolated quaternion
    */
-  static Quaternion lerp(const Quaternion &q1, const Quaternion &q2, double t);
+  static Quaternion lerp(const Quaternion &q1, const Quaternion &q2,
+                         float t) {
+    if (t < 0.0f)
+      t = 0.0f;
+    if (t > 1.0f)
+      t = 1.0f;
+
+    float dot_product = dot(q1, q2);
+    Quaternion q2_adjusted = q2;
+
+    // Take the shortest path
+    if (dot_product < 0.0f) {
+      q2_adjusted = q2_adjusted * -1.0f;
+    }
+
+    Quaternion result = q1 * (1.0f - t) + q2_adjusted * t;
+    return result.normalized();
+  }
 
   /**
    * @brief Spherical linear interpolation (slerp) between two quaternions
@@ -158,19 +325,70 @@ public:
    * @param t Interpolation parameter (0 to 1)
    * @return Interpolated quaternion
    */
-  static Quaternion slerp(const Quaternion &q1, const Quaternion &q2, double t);
+  static Quaternion slerp(const Quaternion &q1, const Quaternion &q2,
+                          float t) {
+    if (t < 0.0f)
+      t = 0.0f;
+    if (t > 1.0f)
+      t = 1.0f;
+
+    float dot_product = dot(q1, q2);
+    Quaternion q2_adjusted = q2;
+
+    // Take the shortest path
+    if (dot_product < 0.0f) {
+      q2_adjusted = q2_adjusted * -1.0f;
+      dot_product = -dot_product;
+    }
+
+    // Clamp dot product to avoid numerical issues
+    if (dot_product > 0.9995f) {
+      // Quaternions are very close, use linear interpolation
+      return lerp(q1, q2_adjusted, t);
+    }
+
+    // Calculate the angle between quaternions
+    float theta = std::acos(dot_product);
+    float sin_theta = std::sin(theta);
+
+    float w1 = std::sin((1.0f - t) * theta) / sin_theta;
+    float w2 = std::sin(t * theta) / sin_theta;
+
+    Quaternion result = q1 * w1 + q2_adjusted * w2;
+    return result.normalized();
+  }
 
   /**
    * @brief Get the rotation axis from this quaternion
    * @return Normalized rotation axis
    */
-  Vec3 getAxis() const;
+  Vec3 getAxis() const {
+    float sin_half_theta = std::sqrt(x * x + y * y + z * z);
+
+    if (sin_half_theta < 1e-6f) {
+      // Angle is near zero, return arbitrary axis
+      return Vec3(1.0f, 0.0f, 0.0f);
+    }
+
+    return Vec3(x, y, z) / sin_half_theta;
+  }
 
   /**
    * @brief Get the rotation angle from this quaternion
    * @return Rotation angle in radians (0 to 2π)
    */
-  double getAngle() const;
+  float getAngle() const {
+    float mag = magnitude();
+    if (mag == 0.0f)
+      return 0.0f;
+
+    float w_normalized = w / mag;
+    // Clamp to [-1, 1] to avoid numerical issues with acos
+    w_normalized = w_normalized < -1.0f
+                       ? -1.0f
+                       : (w_normalized > 1.0f ? 1.0f : w_normalized);
+    return 2.0f * std::acos(w_normalized);
+  }
 
   /**
    * @brief Convert quaternion to Euler angles (ZYX convention)
@@ -178,15 +396,47 @@ public:
    * @param pitch Output: rotation around Y axis in radians
    * @param yaw Output: rotation around Z axis in radians
    */
-  void toEulerAngles(double &roll, double &pitch, double &yaw) const;
+  void toEulerAngles(float &roll, float &pitch, float &yaw) const {
+    // Roll (rotation about X axis)
+    float sinr_cosp = 2.0f * (w * x + y * z);
+    float cosr_cosp = 1.0f - 2.0f * (x * x + y * y);
+    roll = std::atan2(sinr_cosp, cosr_cosp);
+
+    // Pitch (rotation about Y axis)
+    float sinp = 2.0f * (w * y - z * x);
+    if (std::abs(sinp) >= 1.0f) {
+      pitch = std::copysign(static_cast<float>(M_PI) / 2.0f, sinp);
+    } else {
+      pitch = std::asin(sinp);
+    }
+
+    // Yaw (rotation about Z axis)
+    float siny_cosp = 2.0f * (w * z + x * y);
+    float cosy_cosp = 1.0f - 2.0f * (y * y + z * z);
+    yaw = std::atan2(siny_cosp, cosy_cosp);
+  }
 
   /**
    * @brief Dot product of two quaternions
    */
-  static double dot(const Quaternion &q1, const Quaternion &q2);
+  static float dot(const Quaternion &q1, const Quaternion &q2) {
+#if defined(VEC_MATH_SSE)
+    __m128 m = _mm_mul_ps(q1.v, q2.v);
+    __m128 shuf = _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(m, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+#elif defined(VEC_MATH_NEON)
+    return vaddvq_f32(vmulq_f32(q1.v, q2.v));
+#else
+    return q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
+#endif
+  }
 };
 
 // Helper function for scalar * quaternion
-Quaternion operator*(double scalar, const Quaternion &q);
+inline Quaternion operator*(float scalar, const Quaternion &q) {
+  return q * scalar;
+}
 
 #endif // QUATERNION_H
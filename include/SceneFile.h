@@ -0,0 +1,85 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include "VulkanRenderer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Baked binary scene container (.ptsc): the on-disk records are exactly the
+// GPU structs (GPUSphere, GPUEllipsoid, GPUMaterial, GPULight,
+// GPUVolumetricData), so loading is a single memory-map plus typed pointer
+// fixups - no per-object parsing or conversion. The arrays feed straight
+// into VulkanRenderer::updateScene, which makes startup for large baked
+// scenes bounded by the upload, not by scene translation.
+//
+// Layout: Header (32 bytes, keeping every array 16-byte aligned), then the
+// five arrays back to back in the order spheres, ellipsoids, materials,
+// lights, volumes. Material indices inside the records are already resolved
+// (the writer is fed SceneManager::prepareForRender output).
+class SceneFile {
+public:
+  static constexpr uint32_t MAGIC = 0x43535450; // "PTSC" little-endian
+  static constexpr uint32_t VERSION = 1;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sphereCount;
+    uint32_t ellipsoidCount;
+    uint32_t materialCount;
+    uint32_t lightCount;
+    uint32_t volumeCount;
+    uint32_t padding;
+  };
+
+  SceneFile() = default;
+  ~SceneFile();
+
+  // The mapping is tied to this instance
+  SceneFile(const SceneFile &) = delete;
+  SceneFile &operator=(const SceneFile &) = delete;
+
+  // Memory-map an existing .ptsc file
+  bool open(const std::string &path);
+  void close();
+
+  bool isOpen() const { return mapped_ != nullptr; }
+
+  // Typed views into the mapping; valid while the file stays open
+  const GPUSphere *spheres() const { return spheres_; }
+  size_t sphereCount() const { return header_.sphereCount; }
+  const GPUEllipsoid *ellipsoids() const { return ellipsoids_; }
+  size_t ellipsoidCount() const { return header_.ellipsoidCount; }
+  const GPUMaterial *materials() const { return materials_; }
+  size_t materialCount() const { return header_.materialCount; }
+  const GPULight *lights() const { return lights_; }
+  size_t lightCount() const { return header_.lightCount; }
+  const GPUVolumetricData *volumes() const { return volumes_; }
+  size_t volumeCount() const { return header_.volumeCount; }
+
+  // Offline writer: bake converted prepareForRender output so the hardcoded
+  // setup (or any other scene source) can be reloaded without recompiling
+  static bool write(const std::string &path,
+                    const std::vector<GPUSphere> &spheres,
+                    const std::vector<GPUEllipsoid> &ellipsoids,
+                    const std::vector<GPUMaterial> &materials,
+                    const std::vector<GPULight> &lights,
+                    const std::vector<GPUVolumetricData> &volumes);
+
+private:
+  void *mapped_ = nullptr;
+  size_t mappedSize_ = 0;
+  Header header_{};
+
+  // Pointer fixups into the mapping, computed once at open
+  const GPUSphere *spheres_ = nullptr;
+  const GPUEllipsoid *ellipsoids_ = nullptr;
+  const GPUMaterial *materials_ = nullptr;
+  const GPULight *lights_ = nullptr;
+  const GPUVolumetricData *volumes_ = nullptr;
+};
+
+#endif // SCENE_FILE_H
@@ -1,14 +1,19 @@
 #ifndef SCENE_WRAPPERS_H
 #define SCENE_WRAPPERS_H
 
+#include <cstddef>
+#include <cstring>
 #include <glm/glm.hpp>
 #include <string>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <unordered_map>
 #include <vector>
 
 // Forward declarations of GPU structures
 struct GPUMaterial;
 struct GPUSphere;
+struct GPUTriangle;
 struct GPULight;
 struct GPUVolumetricData;
 
@@ -156,6 +161,28 @@ public:
   GPUMaterial toGPU(const std::unordered_map<std::string, int>
                         &shaderPathToIndex) const noexcept;
 
+  // FNV-1a hash over the packed parameter block and shader path, used by
+  // SceneManager::prepareForRender to intern identical materials. The
+  // padding fields are always zero, so hashing the raw bytes is stable.
+  size_t contentHash() const noexcept {
+    const unsigned char *bytes =
+        reinterpret_cast<const unsigned char *>(&data_);
+    size_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < sizeof(data_); i++) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    for (char c : shaderPath_) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  // Exact content comparison backing the hash (collision guard)
+  bool contentEquals(const Material &other) const noexcept {
+    return std::memcmp(&data_, &other.data_, sizeof(data_)) == 0 &&
+           shaderPath_ == other.shaderPath_;
+  }
+
 private:
   // Union for transparent access to packed data
   union {
@@ -225,6 +252,55 @@ private:
   int materialIndex_;        // Resolved index after pre-render
 };
 
+// Triangle mesh wrapper: indexed geometry (world-space vertices, three
+// indices per face) sharing one material. Plugs into
+// SceneManager::prepareForRender like the other wrappers; toGPU flattens the
+// index buffer into one GPUTriangle per face, which is what the renderer
+// uploads and the scene BVH leaves reference directly.
+class Mesh {
+public:
+  Mesh() noexcept : material_(nullptr), materialIndex_(-1) {}
+
+  Mesh(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices,
+       const Material &material) noexcept
+      : vertices_(std::move(vertices)), indices_(std::move(indices)),
+        material_(&material), materialIndex_(-1) {}
+
+  // Accessors
+  const std::vector<glm::vec3> &getVertices() const noexcept {
+    return vertices_;
+  }
+  const std::vector<uint32_t> &getIndices() const noexcept { return indices_; }
+  constexpr int getMaterialIndex() const noexcept { return materialIndex_; }
+  const Material *getMaterial() const noexcept { return material_; }
+  size_t getTriangleCount() const noexcept { return indices_.size() / 3; }
+
+  // Mutators
+  void setVertices(std::vector<glm::vec3> vertices) noexcept {
+    vertices_ = std::move(vertices);
+  }
+  void setIndices(std::vector<uint32_t> indices) noexcept {
+    indices_ = std::move(indices);
+  }
+  void setMaterial(const Material &material) noexcept {
+    material_ = &material;
+    materialIndex_ = -1; // Reset index when material changes
+  }
+
+  // Internal method used by pre-render to set resolved material index
+  void setMaterialIndex(int index) noexcept { materialIndex_ = index; }
+
+  // Convert to GPU format: appends one GPUTriangle per indexed face.
+  // Out-of-range or truncated index triples are skipped.
+  void appendGPUTriangles(std::vector<GPUTriangle> &out) const noexcept;
+
+private:
+  std::vector<glm::vec3> vertices_;
+  std::vector<uint32_t> indices_;
+  const Material *material_; // Reference to material instance
+  int materialIndex_;        // Resolved index after pre-render
+};
+
 // Light wrapper class
 class Light {
 public:
@@ -316,40 +392,62 @@ private:
 class SceneManager {
 public:
   // Pre-render method that builds material list and maps object materials to
-  // indices Takes sphere and volumetric object lists, extracts unique
-  // materials, and updates material indices in objects
+  // indices. Materials are interned by content (hash of the packed parameter
+  // block plus shader path), so distinct instances carrying identical
+  // parameters - common in baked scenes with hundreds of thousands of
+  // objects over a few hundred materials - collapse to one slot. Interning
+  // touches each unique material pointer once; the per-object index
+  // assignment is pure O(1) lookups and fans out over TBB.
   template <typename... ObjectContainers>
   static void prepareForRender(std::vector<Material> &outMaterials,
                                ObjectContainers &...objectContainers) {
     outMaterials.clear();
-    std::unordered_map<const Material *, int> materialIndexMap;
+    std::unordered_map<const Material *, int> pointerToIndex;
+    std::unordered_map<size_t, std::vector<int>> hashBuckets;
 
-    // Helper lambda to process a container of objects
-    auto processContainer = [&](auto &container) {
-      using ObjectType = typename std::decay_t<decltype(container)>::value_type;
+    // Pass 1 (serial): intern unique materials. Pointer identity is the
+    // fast path; new pointers fall through to the content-hash table, with
+    // an exact comparison guarding against collisions.
+    auto internMaterials = [&](auto &container) {
       for (auto &obj : container) {
         const Material *mat = obj.getMaterial();
-        if (mat == nullptr) {
-          continue; // Skip objects without materials
+        if (mat == nullptr || pointerToIndex.count(mat) != 0) {
+          continue;
         }
 
-        // Check if this material is already in our map
-        auto it = materialIndexMap.find(mat);
-        if (it == materialIndexMap.end()) {
-          // New material - add it to the list
-          int newIndex = static_cast<int>(outMaterials.size());
+        std::vector<int> &bucket = hashBuckets[mat->contentHash()];
+        int index = -1;
+        for (int candidate : bucket) {
+          if (outMaterials[candidate].contentEquals(*mat)) {
+            index = candidate;
+            break;
+          }
+        }
+        if (index < 0) {
+          index = static_cast<int>(outMaterials.size());
           outMaterials.push_back(*mat);
-          materialIndexMap[mat] = newIndex;
-          obj.setMaterialIndex(newIndex);
-        } else {
-          // Material already exists - use existing index
-          obj.setMaterialIndex(it->second);
+          bucket.push_back(index);
         }
+        pointerToIndex.emplace(mat, index);
       }
     };
-
-    // Process all provided containers
-    (processContainer(objectContainers), ...);
+    (internMaterials(objectContainers), ...);
+
+    // Pass 2 (parallel): write resolved indices back into the objects; the
+    // lookup table is read-only here, so the containers split freely
+    auto assignIndices = [&](auto &container) {
+      tbb::parallel_for(
+          tbb::blocked_range<size_t>(0, container.size()),
+          [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); i++) {
+              const Material *mat = container[i].getMaterial();
+              if (mat != nullptr) {
+                container[i].setMaterialIndex(pointerToIndex.find(mat)->second);
+              }
+            }
+          });
+    };
+    (assignIndices(objectContainers), ...);
   }
 };
 
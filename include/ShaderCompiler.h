@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <unordered_map>
@@ -12,6 +13,18 @@ public:
   static std::vector<uint32_t> compileShader(const std::string &shaderPath,
                                              VkShaderStageFlagBits stage);
 
+  // Compile composed shader source with an on-disk SPIR-V cache keyed by a
+  // hash of the source. Since the source already contains the injected
+  // surface shaders, the key changes whenever raytrace.comp or any .glsl in
+  // the surface shader directory changes. Warm starts skip glslc entirely.
+  static std::vector<uint32_t>
+  compileShaderSourceCached(const std::string &shaderSource,
+                            const std::string &tempShaderPath,
+                            const std::string &cacheDir);
+
+  // FNV-1a hash used as the SPIR-V cache key
+  static uint64_t hashShaderSource(const std::string &source);
+
   // Load surface shaders from directory and inject into main shader
   // Returns the modified shader source and fills outPathToIndex with
   // path->index mapping
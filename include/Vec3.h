@@ -1,39 +1,150 @@
 #ifndef VEC3_H
 #define VEC3_H
 
-class Vec3 {
+#include <cmath>
+
+// 4-lane SIMD backend selection, shared with Quaternion.h
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VEC_MATH_SSE 1
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define VEC_MATH_NEON 1
+#endif
+
+// Header-only float vector over a 4-lane SIMD register (SSE/NEON, with a
+// scalar fallback). The fourth lane is kept at zero by every operation, so
+// dot products and lengths can sum all four lanes without masking. Everything
+// is inline: the per-frame animation path churns through these in the main
+// loop, and out-of-line double math was measurable there.
+class alignas(16) Vec3 {
 public:
-  double x, y, z;
+  union {
+#if defined(VEC_MATH_SSE)
+    __m128 v;
+#elif defined(VEC_MATH_NEON)
+    float32x4_t v;
+#endif
+    struct {
+      float x, y, z;
+      float pad_; // Always zero, see class comment
+    };
+  };
 
-  Vec3();
-  Vec3(double x, double y, double z);
+#if defined(VEC_MATH_SSE)
+  Vec3() : v(_mm_setzero_ps()) {}
+  Vec3(float x, float y, float z) : v(_mm_set_ps(0.0f, z, y, x)) {}
+  explicit Vec3(__m128 raw) : v(raw) {}
+#elif defined(VEC_MATH_NEON)
+  Vec3() : v(vdupq_n_f32(0.0f)) {}
+  Vec3(float x, float y, float z) {
+    float lanes[4] = {x, y, z, 0.0f};
+    v = vld1q_f32(lanes);
+  }
+  explicit Vec3(float32x4_t raw) : v(raw) {}
+#else
+  Vec3() : x(0.0f), y(0.0f), z(0.0f), pad_(0.0f) {}
+  Vec3(float x, float y, float z) : x(x), y(y), z(z), pad_(0.0f) {}
+#endif
 
   // Vector operations
-  Vec3 operator+(const Vec3 &v) const;
-  Vec3 operator-(const Vec3 &v) const;
-  Vec3 operator*(double t) const;
-  Vec3 operator/(double t) const;
+  Vec3 operator+(const Vec3 &o) const {
+#if defined(VEC_MATH_SSE)
+    return Vec3(_mm_add_ps(v, o.v));
+#elif defined(VEC_MATH_NEON)
+    return Vec3(vaddq_f32(v, o.v));
+#else
+    return Vec3(x + o.x, y + o.y, z + o.z);
+#endif
+  }
+
+  Vec3 operator-(const Vec3 &o) const {
+#if defined(VEC_MATH_SSE)
+    return Vec3(_mm_sub_ps(v, o.v));
+#elif defined(VEC_MATH_NEON)
+    return Vec3(vsubq_f32(v, o.v));
+#else
+    return Vec3(x - o.x, y - o.y, z - o.z);
+#endif
+  }
+
+  Vec3 operator*(float t) const {
+#if defined(VEC_MATH_SSE)
+    return Vec3(_mm_mul_ps(v, _mm_set1_ps(t)));
+#elif defined(VEC_MATH_NEON)
+    return Vec3(vmulq_n_f32(v, t));
+#else
+    return Vec3(x * t, y * t, z * t);
+#endif
+  }
 
-  Vec3 &operator+=(const Vec3 &v);
-  Vec3 &operator*=(double t);
-  Vec3 &operator/=(double t);
+  Vec3 operator/(float t) const { return *this * (1.0f / t); }
 
-  // Dot product
-  double dot(const Vec3 &v) const;
+  Vec3 &operator+=(const Vec3 &o) {
+    *this = *this + o;
+    return *this;
+  }
+
+  Vec3 &operator*=(float t) {
+    *this = *this * t;
+    return *this;
+  }
+
+  Vec3 &operator/=(float t) {
+    *this = *this / t;
+    return *this;
+  }
+
+  // Dot product (the zeroed fourth lane lets this sum all four)
+  float dot(const Vec3 &o) const {
+#if defined(VEC_MATH_SSE)
+    __m128 m = _mm_mul_ps(v, o.v);
+    __m128 shuf = _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(m, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+#elif defined(VEC_MATH_NEON)
+    return vaddvq_f32(vmulq_f32(v, o.v));
+#else
+    return x * o.x + y * o.y + z * o.z;
+#endif
+  }
 
   // Cross product
-  Vec3 cross(const Vec3 &v) const;
+  Vec3 cross(const Vec3 &o) const {
+#if defined(VEC_MATH_SSE)
+    __m128 a_yzx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 b_yzx = _mm_shuffle_ps(o.v, o.v, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 c = _mm_sub_ps(_mm_mul_ps(v, b_yzx), _mm_mul_ps(a_yzx, o.v));
+    return Vec3(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)));
+#else
+    return Vec3(y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x);
+#endif
+  }
 
   // Length operations
-  double length() const;
-  double lengthSquared() const;
+  float length() const { return std::sqrt(lengthSquared()); }
+  float lengthSquared() const { return dot(*this); }
 
   // Normalization
-  Vec3 normalized() const;
-  void normalize();
+  Vec3 normalized() const {
+    float len = length();
+    if (len > 0.0f) {
+      return *this / len;
+    }
+    return *this;
+  }
+
+  void normalize() {
+    float len = length();
+    if (len > 0.0f) {
+      *this /= len;
+    }
+  }
 };
 
 // Helper function for scalar * vector
-Vec3 operator*(double t, const Vec3 &v);
+inline Vec3 operator*(float t, const Vec3 &v) { return v * t; }
 
 #endif // VEC3_H
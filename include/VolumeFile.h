@@ -0,0 +1,76 @@
+#ifndef VOLUME_FILE_H
+#define VOLUME_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <string>
+
+// Bricked volume container (.ptvb): uint8 density voxels reorganized into
+// 32^3 bricks laid out in Morton order of their brick coordinates. The file
+// is memory-mapped, so opening is O(1) regardless of volume size and only
+// the bricks actually read ever page in. Bricks that contain no density are
+// left as file holes - the filesystem stores nothing for them and the
+// mapping reads back zeros - which makes sparse CT volumes both small on
+// disk and cheap to walk.
+//
+// Layout: Header, then bricks of BRICK_BYTES each at
+//   headerSize + mortonIndex(bx, by, bz) * BRICK_BYTES
+// over the next-power-of-two padded brick grid. Voxels within a brick are
+// x-fastest (z * 32^2 + y * 32 + x), zero-padded at the volume edge.
+class VolumeFile {
+public:
+  static constexpr uint32_t MAGIC = 0x42565450; // "PTVB" little-endian
+  static constexpr uint32_t VERSION = 1;
+  static constexpr int BRICK_SIZE = 32;
+  static constexpr size_t BRICK_BYTES =
+      static_cast<size_t>(BRICK_SIZE) * BRICK_SIZE * BRICK_SIZE;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t resolution[3];
+    uint32_t brickSize;
+    uint32_t brickCount[3];
+    uint32_t padding;
+  };
+
+  VolumeFile() = default;
+  ~VolumeFile();
+
+  // The mapping is tied to this instance
+  VolumeFile(const VolumeFile &) = delete;
+  VolumeFile &operator=(const VolumeFile &) = delete;
+
+  // Memory-map an existing .ptvb file
+  bool open(const std::string &path);
+  void close();
+
+  bool isOpen() const { return mapped_ != nullptr; }
+  glm::ivec3 resolution() const;
+  glm::ivec3 brickCount() const;
+
+  // Pointer to a brick's BRICK_BYTES of voxels; valid while the file stays
+  // open. Reading an empty brick's hole pages in shared zero pages only.
+  const uint8_t *brickData(int bx, int by, int bz) const;
+
+  // True if the brick contains any nonzero density
+  bool brickOccupied(int bx, int by, int bz) const;
+
+  // Offline converter: stream a flat z-major .raw into the bricked layout.
+  // Works one brick-slab (BRICK_SIZE slices) at a time, so volumes far
+  // larger than RAM convert in bounded memory. All-zero bricks are skipped,
+  // leaving holes.
+  static bool convert(const std::string &rawPath, glm::ivec3 resolution,
+                      const std::string &outPath);
+
+  // Interleave three 10-bit coordinates into a Morton index
+  static uint64_t mortonIndex(uint32_t x, uint32_t y, uint32_t z);
+
+private:
+  void *mapped_ = nullptr;
+  size_t mappedSize_ = 0;
+  Header header_{};
+};
+
+#endif // VOLUME_FILE_H
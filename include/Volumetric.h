@@ -9,6 +9,10 @@ private:
   Vec3 _position;
   double _scale;
   uint8_t *_data;
+  // Precomputed central-difference gradient field, packed as snorm8 xyz per
+  // voxel (normalized direction * 127). Built once at load so GetNormal does
+  // a single fetch instead of six Value() lookups per query.
+  int8_t *_gradients;
   int _resolution[3] = {0};
   double _thickness[3] = {0};
   Vec3 _v0;
@@ -17,6 +21,7 @@ private:
 public:
   Volumetric(std::string datFile, std::string rawFile, Vec3 position,
              double scale, std::shared_ptr<Material> material);
+  ~Volumetric() override;
   bool hit(const Ray &ray, double tMin, double tMax,
            HitRecord &record) const override;
 
@@ -30,6 +35,8 @@ private:
   uint8_t Value(int x, int y, int z) const;
   Vec3 GetIndexes(Vec3 v) const;
   Vec3 GetNormal(Vec3 v) const;
+  // Parallel pass filling _gradients from the loaded density data
+  void BuildGradientField();
 };
 
 #endif
\ No newline at end of file
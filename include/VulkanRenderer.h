@@ -3,14 +3,19 @@
 
 #include "Ellipsoid.h"
 #include <SDL3/SDL.h>
+#include <atomic>
+#include <deque>
 #include <glm/glm.hpp>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <vulkan/vulkan.h>
 
 // Forward declarations
 class VulkanDevice;
+class VolumeFile;
 
 // GPU-friendly scene data structures
 struct GPUSphere {
@@ -22,6 +27,18 @@ struct GPUSphere {
 
 // GPUEllipsoid is defined in Ellipsoid.h
 
+// One flattened triangle, std430-compatible (three vec3s padded to vec4
+// slots). Meshes are uploaded as a flat triangle list so BVH leaves can
+// index faces directly without an indirection through an index buffer.
+struct GPUTriangle {
+  glm::vec3 v0;
+  int materialIndex;
+  glm::vec3 v1;
+  float padding1;
+  glm::vec3 v2;
+  float padding2;
+};
+
 struct GPUMaterial {
   glm::vec4 colorAndAmbient;      // color.xyz, ambient.w
   glm::vec4 diffuseSpecularShiny; // diffuse.x, specular.y, shininess.z,
@@ -49,6 +66,19 @@ struct GPUVolumetricData {
   int resolution_z;
   int materialIndex;
   int padding[2];
+  // Placement inside the shared density atlas, filled in by the renderer
+  // (updateVolumes): per-axis scale from volume-local [0,1] coordinates to
+  // atlas texture coordinates, and the normalized z offset of this volume's
+  // slab. Callers can leave these zero.
+  glm::vec3 atlasScale;
+  float atlasOffsetZ;
+};
+
+// Per-ellipsoid record for the GPU animation pre-pass: rotation axis in
+// xyz (normalized on the GPU), angular velocity in w expressed in radians
+// per unit of PushConstants::time
+struct GPUAnimation {
+  glm::vec4 axisAngularVel;
 };
 
 // Push constants for shader
@@ -61,13 +91,15 @@ struct PushConstants {
   int numLights;           // offset 88, size 4
   int numVolumes;          // offset 92, size 4
   int maxDepth;            // offset 96, size 4
-  int padding1;            // offset 100, size 4
-  int padding2;            // offset 104, size 4
-  int padding3;            // offset 108, size 4
+  int numBVHNodes;         // offset 100, size 4 (filled in by the renderer)
+  int sampleCount;         // offset 104, size 4 (filled in by the renderer)
+  int scrambleIndex;       // offset 108, size 4 (filled in by the renderer)
   glm::vec3 bgColorTop;    // offset 112, size 12 (vec3 aligned to 16)
-  float padding4;          // offset 124, size 4
+  float renderWidth;       // offset 124, size 4 (filled in by the renderer;
+                           // 0 means full image)
   glm::vec3 bgColorBottom; // offset 128, size 12 (vec3 aligned to 16)
-  float padding5;          // offset 140, size 4
+  float renderHeight;      // offset 140, size 4 (filled in by the renderer)
+  int numTriangles;        // offset 144, size 4 (filled in by the renderer)
 };
 
 class VulkanRenderer {
@@ -78,19 +110,110 @@ public:
   bool initialize(SDL_Window *window, int width, int height);
   void shutdown();
 
+  // Full scene upload - equivalent to calling every per-category setter
   void
   updateScene(const std::vector<GPUSphere> &spheres,
               const std::vector<GPUEllipsoid> &ellipsoids,
               const std::vector<GPUMaterial> &materials,
               const std::vector<GPULight> &lights,
               const std::vector<GPUVolumetricData> &volumes,
-              const std::vector<uint8_t> &voxelData = std::vector<uint8_t>());
+              const std::vector<uint8_t> &voxelData = std::vector<uint8_t>(),
+              const std::vector<GPUTriangle> &triangles =
+                  std::vector<GPUTriangle>());
+
+  // Per-category setters for dirty-tracked updates: only call these for data
+  // that actually changed, unchanged buffers are never touched. Sphere and
+  // ellipsoid updates also rebuild the BVH. Uploads from all setters called
+  // in a frame are batched into a single copy submission.
+  void updateSpheres(const std::vector<GPUSphere> &spheres);
+  void updateEllipsoids(const std::vector<GPUEllipsoid> &ellipsoids);
+  // Flat triangle list (meshes flattened by the caller, one GPUTriangle per
+  // face). Triangles share the scene BVH with spheres and ellipsoids, so
+  // this also triggers a rebuild. The buffer grows on demand for large
+  // meshes; growth drains the queue first, so reserve it for load time.
+  void updateTriangles(const std::vector<GPUTriangle> &triangles);
+  void updateMaterials(const std::vector<GPUMaterial> &materials);
+  void updateLights(const std::vector<GPULight> &lights);
+  void updateVolumes(const std::vector<GPUVolumetricData> &volumes);
+  // Upload one volume's density bytes into its slab of the shared atlas.
+  // Volumes can be uploaded incrementally in any order after updateVolumes;
+  // not-yet-uploaded volumes sample as empty space.
+  void updateVolumeDensity(int volumeIndex, const std::vector<uint8_t> &voxelData);
+  // Convenience wrapper: upload the density of volume 0
+  void updateVoxelData(const std::vector<uint8_t> &voxelData);
+  // Streaming upload from a memory-mapped bricked volume into volume 0's
+  // slab: only occupied bricks are copied (in bounded staging chunks), so
+  // volumes far larger than the flat path could hold in RAM load directly
+  // from disk
+  void updateVoxelData(const VolumeFile &volume);
+
+  // Move the per-frame ellipsoid spin onto the GPU: register one animation
+  // record per ellipsoid and a small compute pre-pass rewrites each rotation
+  // in place from pushConst.time before the trace dispatch, so animated
+  // scenes stop re-uploading the ellipsoid buffer and rebuilding the BVH
+  // every frame. The BVH is rebuilt once here with rotation-invariant
+  // bounds. Pass an empty vector to return to CPU-side updates.
+  void setEllipsoidAnimations(const std::vector<GPUAnimation> &animations);
 
   void render(const PushConstants &pushConstants);
   void present();
 
+  // Headless batch rendering: when enabled, every frame's command buffer
+  // also copies the output image into an alternating host-visible readback
+  // buffer. Call fetchPreviousFrame after render() to get the frame before
+  // the one just submitted (RGBA8, width*height*4 bytes); it waits only on
+  // that older frame's fence, so the GPU keeps working on the current one.
+  void enableReadback();
+  bool fetchPreviousFrame(std::vector<uint8_t> &outPixels);
+  // Blocking fetch of the most recently submitted frame (for draining the
+  // tail of a batch)
+  bool fetchLastFrame(std::vector<uint8_t> &outPixels);
+
+  int getWidth() const { return windowWidth; }
+  int getHeight() const { return windowHeight; }
+
+  // GPU stage timings in milliseconds, measured with timestamp queries around
+  // each command-buffer stage. Average and percentiles are computed over a
+  // rolling window of recent frames; empty stats mean the stage hasn't run
+  // (or the device reports no timestamp support).
+  struct GpuStageStats {
+    double lastMs = 0.0;
+    double averageMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    int sampleCount = 0;
+  };
+  struct GpuTimings {
+    GpuStageStats upload;  // batched scene-upload copies
+    GpuStageStats compute; // path tracing dispatch
+    GpuStageStats blit;    // swapchain blit
+  };
+  GpuTimings getGpuTimings() const;
+
+  // Print a one-line timing readout to stdout every N frames (0 disables)
+  void setGpuTimingLogInterval(int frames) { gpuTimingLogInterval = frames; }
+
+  // Maximum bounce depth, baked into the pipeline as a specialization
+  // constant so the driver can unroll the bounce loop. Must be set before
+  // initialize(); later changes have no effect.
+  void setMaxBounceDepth(int depth) { maxBounceDepth = depth; }
+
   VkImage getOutputImage() const { return vkOutputImage; }
 
+  // Watch raytrace.comp and shaders/surface_shaders for edits, recompile the
+  // composed shader on a background thread (through the same SPIR-V and
+  // pipeline caches as startup), and swap the compute pipeline in between
+  // frames. Failed compiles keep the current pipeline. Call after
+  // initialize(); intended for interactive runs.
+  void enableShaderHotReload();
+
+  // Dynamic resolution: when the compute pass misses targetFrameMs the trace
+  // dispatch shrinks to a sub-region of the output image and the swapchain
+  // blit upsamples from it (linear filter); once there is headroom it grows
+  // back toward full size. Requires timestamp queries; call after
+  // initialize(), intended for interactive swapchain runs.
+  void enableDynamicResolution(double targetFrameMs);
+
   // Get shader path to index mapping (populated after shader loading)
   const std::unordered_map<std::string, int> &getShaderPathToIndexMap() const {
     return shaderPathToIndex_;
@@ -102,6 +225,20 @@ private:
   bool createLogicalDevice();
   bool createCommandPool();
   bool createComputePipeline();
+  // Shader-module + pipeline creation shared by startup and hot reload;
+  // reuses the existing layout, cache, and specialization constants
+  bool buildComputePipelineFromCode(const std::vector<uint32_t> &shaderCode,
+                                    VkPipeline &outPipeline);
+  // Layout + pipeline + descriptor set for the animation pre-pass, built
+  // lazily on the first setEllipsoidAnimations call
+  bool createAnimationPipeline();
+  // Mtime-polling watcher body run on shaderWatchThread_
+  void shaderWatchLoop();
+  // Adopt a background-compiled pipeline at a frame boundary and retire the
+  // old one once no in-flight frame can still reference it
+  void swapPendingPipeline();
+  // Scale the internal render region toward the target compute time
+  void adjustRenderResolution();
   bool createDescriptorSets();
   bool createBuffers();
   bool createSwapChain(SDL_Window *window);
@@ -110,11 +247,78 @@ private:
   bool createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                     VkMemoryPropertyFlags properties, VkBuffer &buffer,
                     VkDeviceMemory &memory);
-  bool copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+
+  // Device-memory arena. Every renderer buffer suballocates from a small set
+  // of large per-memory-type blocks instead of taking its own
+  // vkAllocateMemory, keeping allocation count flat no matter how often
+  // buffers are resized (drivers cap total allocations via
+  // maxMemoryAllocationCount). Host-visible blocks are persistently mapped at
+  // creation; arenaMappedPtr replaces the per-upload map/unmap dance. Freed
+  // ranges go back on a sorted, coalesced free list so resizes recycle space.
+  // Images keep dedicated allocations - they are few and fixed-count.
+  struct ArenaBlock {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    uint32_t memoryTypeIndex = 0;
+    void *mapped = nullptr;
+    // (offset, size) pairs sorted by offset
+    std::vector<std::pair<VkDeviceSize, VkDeviceSize>> freeRanges;
+  };
+  struct ArenaAllocation {
+    int blockIndex = -1;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+  };
+  bool arenaAllocate(const VkMemoryRequirements &memReqs,
+                     VkMemoryPropertyFlags properties, ArenaAllocation &out);
+  void arenaFree(const ArenaAllocation &alloc);
+  // Pointer into the owning block's persistent mapping, or nullptr for
+  // buffers in non-host-visible memory
+  void *arenaMappedPtr(VkBuffer buffer);
+  // Replaces the vkDestroyBuffer + vkFreeMemory pair: returns the buffer's
+  // range to its block and nulls both handles (the memory handle is a
+  // non-owning alias of the block)
+  void destroyArenaBuffer(VkBuffer &buffer, VkDeviceMemory &memory);
+  void destroyArena();
+
+  // Batched scene upload through the persistently-mapped staging ring.
+  // stageUpload suballocates from the current frame's ring region and records
+  // a copy into the frame's upload command buffer; flushSceneUpload submits
+  // all of a frame's copies in one batch. Non-blocking flushes signal a
+  // semaphore the frame's compute submit waits on; blocking flushes (init
+  // paths) drain the queue before returning.
+  void beginSceneUpload();
+  bool stageUpload(VkBuffer dst, const void *src, VkDeviceSize size);
+  void flushSceneUpload(bool blocking = false);
+
+  // Rebuild + upload the BVH from the cached primitive lists
+  void rebuildBVH();
+
+  // (Re)create the 3D density image at the given extent, cleared to zero and
+  // left in the sampled layout
+  bool createVolumeDensityImageResource(int resX, int resY, int resZ);
+  // Recompute the atlas layout from cachedVolumes_, (re)creating the density
+  // image when the packed extent changes, and patch each volume's atlas
+  // placement fields
+  bool ensureVolumeDensityAtlas();
+
+  // Write the stable buffer/image handles into the descriptor sets (the main
+  // set plus, on the direct-write path, one per swapchain image)
+  void refreshDescriptorSets();
+  void writeDescriptorSet(VkDescriptorSet set, VkImageView outputView);
 
   void recordComputeCommands(const PushConstants &pushConstants);
   bool blitToSwapchain();
 
+  // Read back finished timestamp pairs for a frame slot into the rolling
+  // sample windows. Called after the slot's fence has been waited on, so it
+  // never stalls; pairs whose results aren't available yet are skipped and
+  // picked up on a later call.
+  void collectGpuTimings(uint32_t frameSlot);
+  uint32_t timingQueryIndex(uint32_t frameSlot, int stage) const {
+    return (frameSlot * TIMING_STAGE_COUNT + stage) * 2;
+  }
+
   // Vulkan core
   VkInstance vkInstance = VK_NULL_HANDLE;
   VkPhysicalDevice vkPhysicalDevice = VK_NULL_HANDLE;
@@ -122,15 +326,36 @@ private:
   VkQueue vkComputeQueue = VK_NULL_HANDLE;
   VkCommandPool vkCommandPool = VK_NULL_HANDLE;
 
+  // Scene uploads run on a dedicated transfer/DMA queue when the device has
+  // one, so copies overlap the previous frame's tracing. On devices without
+  // a separate transfer family these alias the compute queue and behave as
+  // before. Upload command buffers come from their own pool since pools are
+  // tied to a queue family.
+  VkQueue vkTransferQueue = VK_NULL_HANDLE;
+  VkCommandPool vkTransferCommandPool = VK_NULL_HANDLE;
+  uint32_t computeQueueFamilyIndex = 0;
+  uint32_t transferQueueFamilyIndex = 0;
+
   // Multiple command buffers for frames in flight
   static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
   VkCommandBuffer vkCommandBuffers[MAX_FRAMES_IN_FLIGHT];
+  VkCommandBuffer vkBlitCommandBuffers[MAX_FRAMES_IN_FLIGHT];
   VkFence vkInFlightFences[MAX_FRAMES_IN_FLIGHT];
   uint32_t currentFrame = 0;
 
   // Compute pipeline
   VkPipelineLayout vkPipelineLayout = VK_NULL_HANDLE;
   VkPipeline vkComputePipeline = VK_NULL_HANDLE;
+  VkPipelineCache vkPipelineCache = VK_NULL_HANDLE;
+
+  // Surface-shader hot reload: the watcher thread polls shader mtimes,
+  // compiles off the render loop, and publishes the finished pipeline here;
+  // render() adopts it between frames. Replaced pipelines stay alive until
+  // every in-flight frame has moved past them.
+  std::thread shaderWatchThread_;
+  std::atomic<bool> shaderWatchStop_{false};
+  std::atomic<VkPipeline> pendingComputePipeline_{VK_NULL_HANDLE};
+  std::vector<std::pair<VkPipeline, int>> retiredPipelines_;
   VkDescriptorSetLayout vkDescriptorSetLayout = VK_NULL_HANDLE;
   VkDescriptorPool vkDescriptorPool = VK_NULL_HANDLE;
   VkDescriptorSet vkDescriptorSet = VK_NULL_HANDLE;
@@ -140,6 +365,18 @@ private:
   VkDeviceMemory vkOutputImageMemory = VK_NULL_HANDLE;
   VkImageView vkOutputImageView = VK_NULL_HANDLE;
 
+  // Progressive accumulation image (rgba32f, rgb = running sum, a = sample
+  // count). Accumulation restarts whenever the camera moves or the scene is
+  // updated, so stationary views converge while interaction stays at 1 spp.
+  VkImage vkAccumImage = VK_NULL_HANDLE;
+  VkDeviceMemory vkAccumImageMemory = VK_NULL_HANDLE;
+  VkImageView vkAccumImageView = VK_NULL_HANDLE;
+  bool accumImageInitialized = false;
+  int accumulatedSamples = 0;
+  int scrambleIndex = 0;
+  glm::mat4 lastCameraMatrix = glm::mat4(0.0f);
+  bool sceneDirty = false;
+
   // Storage buffers
   VkBuffer vkSphereBuffer = VK_NULL_HANDLE;
   VkDeviceMemory vkSphereBufferMemory = VK_NULL_HANDLE;
@@ -153,16 +390,108 @@ private:
   VkBuffer vkLightBuffer = VK_NULL_HANDLE;
   VkDeviceMemory vkLightBufferMemory = VK_NULL_HANDLE;
 
+  // Precomputed 2D Sobol sequence, uploaded once at init. The shader applies
+  // a per-pixel Cranley-Patterson rotation (reseeded via scrambleIndex each
+  // time accumulation restarts), so stochastic decisions converge at the
+  // low-discrepancy rate instead of white noise's 1/sqrt(N).
+  static constexpr int SAMPLE_SEQUENCE_LENGTH = 1024;
+  VkBuffer vkSampleBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory vkSampleBufferMemory = VK_NULL_HANDLE;
+
+  // GPU animation pre-pass: a tiny dispatch (64 ellipsoids per workgroup)
+  // that rewrites rotations in place from pushConst.time. It gets its own
+  // layout and pipeline since it sees only the ellipsoid and animation
+  // buffers; the descriptor set comes from the shared pool.
+  VkBuffer vkAnimationBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory vkAnimationBufferMemory = VK_NULL_HANDLE;
+  VkDescriptorSetLayout vkAnimDescriptorSetLayout = VK_NULL_HANDLE;
+  VkPipelineLayout vkAnimPipelineLayout = VK_NULL_HANDLE;
+  VkPipeline vkAnimPipeline = VK_NULL_HANDLE;
+  VkDescriptorSet vkAnimDescriptorSet = VK_NULL_HANDLE;
+  int animationCount_ = 0;
+
   VkBuffer vkVolumeBuffer = VK_NULL_HANDLE;
   VkDeviceMemory vkVolumeBufferMemory = VK_NULL_HANDLE;
 
-  VkBuffer vkVoxelDataBuffer = VK_NULL_HANDLE;
-  VkDeviceMemory vkVoxelDataBufferMemory = VK_NULL_HANDLE;
-  bool voxelDataUploaded = false;  // Flag to track if voxel data is already in VRAM
+  // Voxel density lives in a sampled 3D image (R8_UNORM) so the shader gets
+  // hardware trilinear filtering and texture-cache locality instead of manual
+  // byte unpacking from an SSBO. The image is a packed atlas: every volume
+  // in the scene gets a slab along z (one empty gap slice between slabs so
+  // trilinear taps never bleed across volumes). A 1x1x1 placeholder keeps
+  // the descriptor valid until the first volume is uploaded.
+  VkImage vkVolumeDensityImage = VK_NULL_HANDLE;
+  VkDeviceMemory vkVolumeDensityImageMemory = VK_NULL_HANDLE;
+  VkImageView vkVolumeDensityImageView = VK_NULL_HANDLE;
+  VkSampler vkVolumeDensitySampler = VK_NULL_HANDLE;
+  glm::ivec3 volumeDensityExtent_ = glm::ivec3(0);
+  // Atlas layout and upload state, rebuilt by updateVolumes. The cached copy
+  // of the volume list carries the patched atlas placement fields.
+  std::vector<GPUVolumetricData> cachedVolumes_;
+  std::vector<int> volumeAtlasZOffset_;
+  std::vector<bool> volumeUploaded_;
+  // Coarse brick occupancy grid built on the CPU alongside the density
+  // upload; the march loop skips whole empty bricks. Layout: 4 header uints
+  // (grid resolution xyz + brick size in voxels) then one word per brick.
+  VkBuffer vkOccupancyBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory vkOccupancyBufferMemory = VK_NULL_HANDLE;
+
+  // Persistently-mapped staging ring shared by all per-frame scene uploads.
+  // One region per frame in flight; uploads that don't fit fall back to a
+  // one-shot staging buffer released after the batched submit.
+  static constexpr VkDeviceSize STAGING_REGION_SIZE = 8 * 1024 * 1024;
+  VkBuffer vkStagingRingBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory vkStagingRingMemory = VK_NULL_HANDLE;
+  void *stagingRingMapped = nullptr;
+  VkDeviceSize stagingRingCursor = 0;
+  VkCommandBuffer vkUploadCommandBuffers[MAX_FRAMES_IN_FLIGHT] = {};
+  VkSemaphore vkUploadSemaphores[MAX_FRAMES_IN_FLIGHT] = {};
+  bool uploadRecording = false;
+  bool uploadWaitPending = false;
+  std::vector<std::pair<VkBuffer, VkDeviceMemory>> pendingStagingBuffers;
+  // One-shot staging buffers from async flushes, destroyed once the owning
+  // frame's fence has been waited on again
+  std::vector<std::pair<VkBuffer, VkDeviceMemory>>
+      retiredStagingBuffers[MAX_FRAMES_IN_FLIGHT];
+
+  // BVH over spheres + ellipsoids, rebuilt on scene update. The cached
+  // copies let a sphere-only or ellipsoid-only update rebuild the full
+  // hierarchy.
+  std::vector<GPUSphere> cachedSpheres_;
+  std::vector<GPUEllipsoid> cachedEllipsoids_;
+  std::vector<GPUTriangle> cachedTriangles_;
+  VkBuffer vkTriangleBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory vkTriangleBufferMemory = VK_NULL_HANDLE;
+  // Current capacity in triangles, tracked so updateTriangles knows when the
+  // buffer has to grow
+  size_t triangleBufferCapacity_ = 0;
+  VkBuffer vkBVHNodeBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory vkBVHNodeBufferMemory = VK_NULL_HANDLE;
+  VkBuffer vkBVHIndexBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory vkBVHIndexBufferMemory = VK_NULL_HANDLE;
+  int bvhNodeCount = 0;
 
   int windowWidth = 800;
   int windowHeight = 600;
 
+  // Dynamic resolution state: the trace dispatch covers only the top-left
+  // renderWidth_ x renderHeight_ region of the output image; the swapchain
+  // blit upsamples from that region. The controller nudges renderScale_
+  // toward the target compute time, with a cooldown so in-flight timing
+  // samples settle between changes.
+  bool dynamicResolutionEnabled_ = false;
+  double targetFrameMs_ = 0.0;
+  float renderScale_ = 1.0f;
+  int renderWidth_ = 0;
+  int renderHeight_ = 0;
+  int resolutionCooldown_ = 0;
+
+  // Specialization constants baked into the compute pipeline: workgroup
+  // shape chosen per vendor in createComputePipeline, bounce depth set by
+  // the caller before initialize()
+  uint32_t workgroupSizeX = 16;
+  uint32_t workgroupSizeY = 16;
+  int maxBounceDepth = 10;
+
   // Swapchain for direct presentation
   VkSurfaceKHR vkSurface = VK_NULL_HANDLE;
   VkSwapchainKHR vkSwapchain = VK_NULL_HANDLE;
@@ -174,13 +503,53 @@ private:
   std::vector<VkSemaphore> vkRenderFinishedSemaphores;
   uint32_t currentImageIndex = 0;
 
-  // Readback buffer for GPU to CPU transfer (only for PPM export)
-  VkBuffer vkReadbackBuffer = VK_NULL_HANDLE;
-  VkDeviceMemory vkReadbackBufferMemory = VK_NULL_HANDLE;
+  // Direct-write present path: when the surface supports storage images in a
+  // format SPIR-V's rgba8 can write, the compute pass targets the acquired
+  // swapchain image through a per-image descriptor set and the blit pass is
+  // skipped. Falls back to the blit whenever dynamic resolution has the
+  // render region scaled down (the blit is the upsampler).
+  bool swapchainStorageWrite_ = false;
+  std::vector<VkDescriptorSet> vkSwapchainDescriptorSets_;
+  bool directPresentPending_ = false;
+
+  // Double-buffered readback for headless batch rendering: each frame's
+  // command buffer copies the output image into its slot's host-visible
+  // buffer, so the CPU reads frame N-1 while the GPU renders frame N
+  VkBuffer vkReadbackBuffers[MAX_FRAMES_IN_FLIGHT] = {};
+  VkDeviceMemory vkReadbackBufferMemory[MAX_FRAMES_IN_FLIGHT] = {};
+  void *readbackMapped[MAX_FRAMES_IN_FLIGHT] = {};
+  bool readbackEnabled = false;
+  bool readbackSlotValid[MAX_FRAMES_IN_FLIGHT] = {};
+
+  // Timestamp instrumentation: one begin/end query pair per stage per frame
+  // slot, reset inside the command buffer that rewrites it. Durations go
+  // into per-stage rolling windows that getGpuTimings() summarizes.
+  static constexpr int TIMING_STAGE_UPLOAD = 0;
+  static constexpr int TIMING_STAGE_COMPUTE = 1;
+  static constexpr int TIMING_STAGE_BLIT = 2;
+  static constexpr int TIMING_STAGE_COUNT = 3;
+  static constexpr size_t TIMING_WINDOW = 240;
+  VkQueryPool vkTimestampQueryPool = VK_NULL_HANDLE;
+  bool timestampsSupported = false;
+  // vkCmdResetQueryPool is a graphics/compute-only command, so upload timing
+  // is only available when uploads run on the compute family
+  bool uploadTimestampsSupported = false;
+  float timestampPeriodNs = 0.0f;
+  bool timingQueryIssued[MAX_FRAMES_IN_FLIGHT][TIMING_STAGE_COUNT] = {};
+  std::deque<double> timingSamples[TIMING_STAGE_COUNT];
+  double timingLastMs[TIMING_STAGE_COUNT] = {};
+  int gpuTimingLogInterval = 0;
+  int gpuTimingFrameCounter = 0;
 
   VkPhysicalDeviceProperties deviceProperties;
   VkPhysicalDeviceMemoryProperties memoryProperties;
 
+  // Arena state: blocks grow geometrically per memory type; the map recovers
+  // a buffer's suballocation for mapping and destruction
+  static constexpr VkDeviceSize ARENA_MIN_BLOCK_SIZE = 32 * 1024 * 1024;
+  std::vector<ArenaBlock> arenaBlocks_;
+  std::unordered_map<VkBuffer, ArenaAllocation> arenaAllocations_;
+
   // Whether we should prefer DEVICE_LOCAL buffers and stage uploads (true on
   // discrete GPUs)
   bool useDeviceLocalBuffers = false;
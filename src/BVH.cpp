@@ -0,0 +1,136 @@
+#include "BVH.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Conservative world-space AABB for a rotated ellipsoid. For an ellipsoid
+// with radii r rotated by matrix R, the half-extent along world axis i is
+// sqrt(sum_j (R[i][j] * r[j])^2).
+void ellipsoidAABB(const GPUEllipsoid &e, glm::vec3 &outMin,
+                   glm::vec3 &outMax) {
+  const glm::vec4 &q = e.rotation;
+  // Rotation matrix rows from the quaternion (x, y, z, w)
+  float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+  float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+  float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+  glm::vec3 row0(1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz), 2.0f * (xz + wy));
+  glm::vec3 row1(2.0f * (xy + wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx));
+  glm::vec3 row2(2.0f * (xz - wy), 2.0f * (yz + wx), 1.0f - 2.0f * (xx + yy));
+
+  glm::vec3 halfExtent(
+      std::sqrt(row0.x * row0.x * e.radii.x * e.radii.x +
+                row0.y * row0.y * e.radii.y * e.radii.y +
+                row0.z * row0.z * e.radii.z * e.radii.z),
+      std::sqrt(row1.x * row1.x * e.radii.x * e.radii.x +
+                row1.y * row1.y * e.radii.y * e.radii.y +
+                row1.z * row1.z * e.radii.z * e.radii.z),
+      std::sqrt(row2.x * row2.x * e.radii.x * e.radii.x +
+                row2.y * row2.y * e.radii.y * e.radii.y +
+                row2.z * row2.z * e.radii.z * e.radii.z));
+
+  outMin = e.center - halfExtent;
+  outMax = e.center + halfExtent;
+}
+
+} // namespace
+
+void BVH::build(const std::vector<GPUSphere> &spheres,
+                const std::vector<GPUEllipsoid> &ellipsoids,
+                const std::vector<GPUTriangle> &triangles) {
+  nodes_.clear();
+  primIndices_.clear();
+
+  std::vector<BuildPrim> prims;
+  prims.reserve(spheres.size() + ellipsoids.size() + triangles.size());
+
+  for (size_t i = 0; i < spheres.size(); i++) {
+    BuildPrim prim{};
+    prim.aabbMin = spheres[i].center - glm::vec3(spheres[i].radius);
+    prim.aabbMax = spheres[i].center + glm::vec3(spheres[i].radius);
+    prim.centroid = spheres[i].center;
+    prim.encodedIndex = static_cast<uint32_t>(i);
+    prims.push_back(prim);
+  }
+
+  for (size_t i = 0; i < ellipsoids.size(); i++) {
+    BuildPrim prim{};
+    ellipsoidAABB(ellipsoids[i], prim.aabbMin, prim.aabbMax);
+    prim.centroid = ellipsoids[i].center;
+    prim.encodedIndex = static_cast<uint32_t>(i) | BVH_PRIM_ELLIPSOID_BIT;
+    prims.push_back(prim);
+  }
+
+  for (size_t i = 0; i < triangles.size(); i++) {
+    const GPUTriangle &tri = triangles[i];
+    BuildPrim prim{};
+    prim.aabbMin = glm::min(tri.v0, glm::min(tri.v1, tri.v2));
+    prim.aabbMax = glm::max(tri.v0, glm::max(tri.v1, tri.v2));
+    prim.centroid = (tri.v0 + tri.v1 + tri.v2) * (1.0f / 3.0f);
+    prim.encodedIndex = static_cast<uint32_t>(i) | BVH_PRIM_TRIANGLE_BIT;
+    prims.push_back(prim);
+  }
+
+  if (prims.empty()) {
+    return;
+  }
+
+  nodes_.reserve(prims.size() * 2);
+  primIndices_.reserve(prims.size());
+  buildRecursive(prims, 0, static_cast<int32_t>(prims.size()));
+}
+
+int32_t BVH::buildRecursive(std::vector<BuildPrim> &prims, int32_t first,
+                            int32_t count) {
+  const int32_t nodeIndex = static_cast<int32_t>(nodes_.size());
+  nodes_.push_back(GPUBVHNode{});
+
+  glm::vec3 aabbMin(1e30f);
+  glm::vec3 aabbMax(-1e30f);
+  for (int32_t i = first; i < first + count; i++) {
+    aabbMin = glm::min(aabbMin, prims[i].aabbMin);
+    aabbMax = glm::max(aabbMax, prims[i].aabbMax);
+  }
+
+  // Small node counts become leaves; stack traversal handles the rest
+  const int32_t maxLeafPrims = 4;
+  if (count <= maxLeafPrims) {
+    GPUBVHNode &leaf = nodes_[nodeIndex];
+    leaf.aabbMin = aabbMin;
+    leaf.aabbMax = aabbMax;
+    leaf.leftFirst = static_cast<int32_t>(primIndices_.size());
+    leaf.primCount = count;
+    for (int32_t i = first; i < first + count; i++) {
+      primIndices_.push_back(prims[i].encodedIndex);
+    }
+    return nodeIndex;
+  }
+
+  // Median split on the longest centroid axis
+  glm::vec3 extent = aabbMax - aabbMin;
+  int axis = 0;
+  if (extent.y > extent.x)
+    axis = 1;
+  if (extent.z > extent[axis])
+    axis = 2;
+
+  int32_t mid = first + count / 2;
+  std::nth_element(prims.begin() + first, prims.begin() + mid,
+                   prims.begin() + first + count,
+                   [axis](const BuildPrim &a, const BuildPrim &b) {
+                     return a.centroid[axis] < b.centroid[axis];
+                   });
+
+  // Left child is emitted immediately after this node (depth-first), so only
+  // the right child index needs to be stored.
+  buildRecursive(prims, first, mid - first);
+  int32_t rightChild = buildRecursive(prims, mid, first + count - mid);
+
+  GPUBVHNode &node = nodes_[nodeIndex];
+  node.aabbMin = aabbMin;
+  node.aabbMax = aabbMax;
+  node.leftFirst = rightChild;
+  node.primCount = 0;
+  return nodeIndex;
+}
@@ -0,0 +1,398 @@
+#include "CpuRenderer.h"
+
+// Legacy CPU scene classes. These share names with the SceneWrappers types
+// (Sphere, Material, Light), which is why none of them may leak into the
+// header - everything below stays private to this translation unit.
+#include "Material.h"
+#include "Object.h"
+#include "Quaternion.h"
+#include "Ray.h"
+#include "Sphere.h"
+#include "Volumetric.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <tbb/blocked_range2d.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+namespace {
+
+// Tile edge for the parallel_for grain; 32x32 keeps tiles small enough for
+// work stealing to even out the volume-heavy regions
+constexpr int TILE_SIZE = 32;
+
+// Matches the shader's EPSILON for self-intersection avoidance
+constexpr double RAY_EPSILON = 1e-3;
+
+// World-space step for the volume march (the shader derives its step from
+// the texture resolution; a fixed step is close enough for the fallback)
+constexpr double VOLUME_STEP = 0.02;
+constexpr int VOLUME_MAX_STEPS = 256;
+
+Vec3 toVec3(const glm::vec3 &v) { return Vec3(v.x, v.y, v.z); }
+
+// Component-wise product (throughput and color filtering)
+Vec3 mul(const Vec3 &a, const Vec3 &b) {
+  return Vec3(a.x * b.x, a.y * b.y, a.z * b.z);
+}
+
+std::shared_ptr<Material> toMaterial(const GPUMaterial &m) {
+  return std::make_shared<Material>(
+      Vec3(m.colorAndAmbient.x, m.colorAndAmbient.y, m.colorAndAmbient.z),
+      m.colorAndAmbient.w, m.diffuseSpecularShiny.x, m.diffuseSpecularShiny.y,
+      m.diffuseSpecularShiny.z, m.diffuseSpecularShiny.w,
+      m.transparencyEmissive.x,
+      Vec3(m.emissive.x, m.emissive.y, m.emissive.z), m.transparencyEmissive.y,
+      false, 0.0,
+      Vec3(m.scatterAndAbsorption.x, m.scatterAndAbsorption.y,
+           m.scatterAndAbsorption.z),
+      m.scatterAndAbsorption.w);
+}
+
+// Ellipsoid with quaternion rotation, solved as a unit sphere in the local
+// frame: inverse-rotate the ray about the center, divide by the radii, and
+// intersect. Both transforms are linear, so the ray parameter t carries
+// straight over to world space.
+class EllipsoidObject : public Object {
+public:
+  Vec3 center;
+  Vec3 radii;
+  Quaternion rotation;
+
+  EllipsoidObject(const Vec3 &center, const Vec3 &radii,
+                  const Quaternion &rotation,
+                  std::shared_ptr<Material> material)
+      : Object(material), center(center), radii(radii), rotation(rotation) {}
+
+  bool hit(const Ray &ray, double tMin, double tMax,
+           HitRecord &record) const override {
+    Quaternion inv = rotation.conjugate();
+    Vec3 o = inv.rotateVector(ray.origin - center);
+    Vec3 d = inv.rotateVector(ray.direction);
+    o = Vec3(o.x / radii.x, o.y / radii.y, o.z / radii.z);
+    d = Vec3(d.x / radii.x, d.y / radii.y, d.z / radii.z);
+
+    double a = d.dot(d);
+    double half_b = o.dot(d);
+    double c = o.dot(o) - 1.0;
+
+    double discriminant = half_b * half_b - a * c;
+    if (discriminant < 0) {
+      return false;
+    }
+
+    double sqrtd = std::sqrt(discriminant);
+    double root = (-half_b - sqrtd) / a;
+    if (root < tMin || root > tMax) {
+      root = (-half_b + sqrtd) / a;
+      if (root < tMin || root > tMax) {
+        return false;
+      }
+    }
+
+    record.t = root;
+    record.point = ray.at(root);
+
+    // Gradient of the implicit surface: scale the local-space point by the
+    // inverse radii again, then rotate back to world space
+    Vec3 local = o + d * static_cast<float>(root);
+    Vec3 localNormal(local.x / radii.x, local.y / radii.y, local.z / radii.z);
+    record.normal = rotation.rotateVector(localNormal).normalized();
+    record.material = material.get();
+
+    return true;
+  }
+};
+
+} // namespace
+
+struct CpuRenderer::Impl {
+  int width;
+  int height;
+
+  std::vector<std::shared_ptr<Material>> materials;
+  std::vector<std::shared_ptr<Object>> objects; // spheres + ellipsoids
+  std::vector<std::shared_ptr<EllipsoidObject>> ellipsoids; // animation aliases
+  std::vector<std::shared_ptr<Volumetric>> volumes;
+  std::vector<GPULight> lights;
+
+  // Per-thread hit-record arena: each worker reuses its own records across
+  // every pixel of every tile it steals, so tracing allocates nothing
+  struct Scratch {
+    HitRecord rec;
+    HitRecord candidate;
+    HitRecord shadow;
+  };
+  tbb::enumerable_thread_specific<Scratch> scratch;
+
+  Impl(int w, int h) : width(w), height(h) {}
+
+  std::shared_ptr<Material> materialAt(int index) {
+    if (index >= 0 && index < static_cast<int>(materials.size())) {
+      return materials[index];
+    }
+    return std::make_shared<Material>();
+  }
+
+  // Closest hit over solids and volume bounding boxes. Sphere::hit predates
+  // the volumetric fields, so they are reset per candidate.
+  bool closestHit(const Ray &ray, double tMin, double tMax, HitRecord &rec,
+                  HitRecord &candidate) const {
+    bool hitAnything = false;
+    double closest = tMax;
+
+    for (const auto &object : objects) {
+      candidate.volumetricHit = false;
+      candidate.objectPtr = nullptr;
+      if (object->hit(ray, tMin, closest, candidate)) {
+        hitAnything = true;
+        closest = candidate.t;
+        rec = candidate;
+      }
+    }
+
+    for (const auto &volume : volumes) {
+      candidate.volumetricHit = false;
+      candidate.objectPtr = nullptr;
+      if (volume->hit(ray, tMin, closest, candidate)) {
+        hitAnything = true;
+        closest = candidate.t;
+        rec = candidate;
+      }
+    }
+
+    return hitAnything;
+  }
+
+  // Binary shadow test against solids only, mirroring getShadowFactor
+  bool occluded(const Ray &ray, double maxDist, HitRecord &shadow) const {
+    for (const auto &object : objects) {
+      if (object->hit(ray, RAY_EPSILON, maxDist, shadow)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Phong shading at a solid hit, mirroring calculateLighting in the
+  // compute shader (ambient + emissive + shadowed Blinn-Phong per light
+  // with the same distance attenuation)
+  Vec3 shadeSurface(const HitRecord &rec, const Vec3 &viewDir,
+                    HitRecord &shadow) const {
+    const Material &mat = *rec.material;
+
+    Vec3 finalColor = mat.color * static_cast<float>(mat.ambient);
+    if (mat.emissiveStrength > 0.0) {
+      finalColor += mat.color * static_cast<float>(mat.emissiveStrength);
+    }
+
+    for (const auto &light : lights) {
+      Vec3 lightPos = toVec3(light.position);
+      Vec3 lightVec = lightPos - rec.point;
+      double distance = lightVec.length();
+      Vec3 lightDir = lightVec / static_cast<float>(distance);
+
+      if (occluded(Ray(rec.point, lightDir), distance, shadow)) {
+        continue;
+      }
+
+      double attenuation = light.intensity / (1.0 + 0.09 * distance +
+                                              0.032 * distance * distance);
+
+      double diffuseStrength = std::max(0.0, (double)rec.normal.dot(lightDir));
+      double diffuse = mat.diffuse * diffuseStrength;
+
+      Vec3 halfDir = (lightDir + viewDir).normalized();
+      double specularStrength =
+          std::pow(std::max(0.0, (double)rec.normal.dot(halfDir)),
+                   mat.shininess);
+      double specular = mat.specular * specularStrength;
+
+      finalColor +=
+          mat.color * static_cast<float>((diffuse + specular) * attenuation);
+    }
+
+    return finalColor;
+  }
+
+  // Absorption-only march through a volume from the entry point to the box
+  // exit; returns (scatterColor, alpha) like the shader's rayMarchVolume
+  Vec3 marchVolume(const Volumetric &volume, const Ray &ray,
+                   const Vec3 &entryPoint, double &alpha) const {
+    const Material &mat = *volume.material;
+    Vec3 exitPoint = volume.getExitPoint(ray, entryPoint);
+    double segment = (exitPoint - entryPoint).length();
+
+    int steps = std::min(
+        VOLUME_MAX_STEPS, std::max(1, static_cast<int>(segment / VOLUME_STEP)));
+    double stepSize = segment / steps;
+    Vec3 stepVec = ray.direction.normalized() * static_cast<float>(stepSize);
+
+    double opticalDepth = 0.0;
+    Vec3 samplePoint = entryPoint;
+    for (int i = 0; i < steps; i++) {
+      opticalDepth +=
+          volume.getDensity(samplePoint) * mat.absorptionCoeff * stepSize;
+      samplePoint += stepVec;
+    }
+
+    alpha = 1.0 - std::exp(-opticalDepth);
+    return mul(mat.color, mat.scatterColor);
+  }
+
+  // Iterative bounce loop mirroring shadeBounce: surface hits accumulate
+  // shading and continue along the reflection while reflectivity holds up,
+  // volume hits composite front-to-back and continue past the exit
+  Vec3 trace(Ray ray, const PushConstants &pushConst, Scratch &s) const {
+    Vec3 color(0.0f, 0.0f, 0.0f);
+    Vec3 throughput(1.0f, 1.0f, 1.0f);
+
+    for (int depth = 0; depth < pushConst.maxDepth; depth++) {
+      if (!closestHit(ray, RAY_EPSILON, 1e30, s.rec, s.candidate)) {
+        // Background gradient, identical to the shader
+        Vec3 unitDir = ray.direction.normalized();
+        float t = 0.5f * (unitDir.y + 1.0f);
+        Vec3 bg = toVec3(pushConst.bgColorBottom) * (1.0f - t) +
+                  toVec3(pushConst.bgColorTop) * t;
+        color += mul(throughput, bg);
+        break;
+      }
+
+      if (s.rec.volumetricHit) {
+        const Volumetric *volume =
+            static_cast<const Volumetric *>(s.rec.objectPtr);
+        double alpha = 0.0;
+        Vec3 volColor = marchVolume(*volume, ray, s.rec.point, alpha);
+        color += mul(throughput, volColor) * static_cast<float>(alpha);
+        throughput *= static_cast<float>(1.0 - alpha);
+        if (throughput.lengthSquared() < 1e-4f) {
+          break;
+        }
+        // Continue the same ray just past the box exit
+        Vec3 exitPoint = volume->getExitPoint(ray, s.rec.point);
+        ray = Ray(exitPoint + ray.direction.normalized() *
+                                  static_cast<float>(RAY_EPSILON),
+                  ray.direction);
+        continue;
+      }
+
+      Vec3 viewDir = (ray.direction * -1.0f).normalized();
+      color += mul(throughput, shadeSurface(s.rec, viewDir, s.shadow));
+
+      double reflectivity = s.rec.material->reflectivity;
+      if (reflectivity <= 0.0) {
+        break;
+      }
+      throughput *= static_cast<float>(reflectivity);
+
+      Vec3 unitDir = ray.direction.normalized();
+      Vec3 reflected =
+          unitDir - s.rec.normal * (2.0f * unitDir.dot(s.rec.normal));
+      ray = Ray(s.rec.point, reflected);
+    }
+
+    return color;
+  }
+
+  void renderFrame(const Camera &camera, const PushConstants &pushConst,
+                   std::vector<uint8_t> &outPixels) {
+    outPixels.resize(static_cast<size_t>(width) * height * 4);
+
+    tbb::parallel_for(
+        tbb::blocked_range2d<int>(0, height, TILE_SIZE, 0, width, TILE_SIZE),
+        [&](const tbb::blocked_range2d<int> &tile) {
+          Scratch &s = scratch.local();
+          for (int y = tile.rows().begin(); y < tile.rows().end(); y++) {
+            for (int x = tile.cols().begin(); x < tile.cols().end(); x++) {
+              double u = (x + 0.5) / width;
+              // Row 0 is the top of the image; the camera's v axis points up
+              double v = 1.0 - (y + 0.5) / height;
+
+              Vec3 color = trace(camera.getRay(u, v), pushConst, s);
+
+              size_t index = (static_cast<size_t>(y) * width + x) * 4;
+              outPixels[index] = static_cast<uint8_t>(
+                  std::clamp(color.x, 0.0f, 1.0f) * 255.99f);
+              outPixels[index + 1] = static_cast<uint8_t>(
+                  std::clamp(color.y, 0.0f, 1.0f) * 255.99f);
+              outPixels[index + 2] = static_cast<uint8_t>(
+                  std::clamp(color.z, 0.0f, 1.0f) * 255.99f);
+              outPixels[index + 3] = 255;
+            }
+          }
+        });
+  }
+};
+
+CpuRenderer::CpuRenderer(int width, int height)
+    : impl_(std::make_unique<Impl>(width, height)) {}
+
+CpuRenderer::~CpuRenderer() = default;
+
+void CpuRenderer::setScene(const std::vector<GPUSphere> &spheres,
+                           const std::vector<GPUEllipsoid> &ellipsoids,
+                           const std::vector<GPUMaterial> &materials,
+                           const std::vector<GPULight> &lights) {
+  impl_->materials.clear();
+  impl_->materials.reserve(materials.size());
+  for (const auto &material : materials) {
+    impl_->materials.push_back(toMaterial(material));
+  }
+
+  impl_->objects.clear();
+  impl_->ellipsoids.clear();
+  for (const auto &sphere : spheres) {
+    impl_->objects.push_back(std::make_shared<Sphere>(
+        toVec3(sphere.center), sphere.radius,
+        impl_->materialAt(sphere.materialIndex)));
+  }
+  for (const auto &ellipsoid : ellipsoids) {
+    auto object = std::make_shared<EllipsoidObject>(
+        toVec3(ellipsoid.center), toVec3(ellipsoid.radii),
+        Quaternion(ellipsoid.rotation.w, ellipsoid.rotation.x,
+                   ellipsoid.rotation.y, ellipsoid.rotation.z),
+        impl_->materialAt(ellipsoid.materialIndex));
+    impl_->ellipsoids.push_back(object);
+    impl_->objects.push_back(object);
+  }
+
+  impl_->lights = lights;
+
+  std::cout << "CPU engine scene set: " << spheres.size() << " spheres, "
+            << ellipsoids.size() << " ellipsoids, " << materials.size()
+            << " materials, " << lights.size() << " lights" << std::endl;
+}
+
+void CpuRenderer::updateEllipsoids(
+    const std::vector<GPUEllipsoid> &ellipsoids) {
+  size_t count = std::min(ellipsoids.size(), impl_->ellipsoids.size());
+  for (size_t i = 0; i < count; i++) {
+    EllipsoidObject &object = *impl_->ellipsoids[i];
+    object.center = toVec3(ellipsoids[i].center);
+    object.radii = toVec3(ellipsoids[i].radii);
+    object.rotation =
+        Quaternion(ellipsoids[i].rotation.w, ellipsoids[i].rotation.x,
+                   ellipsoids[i].rotation.y, ellipsoids[i].rotation.z);
+  }
+}
+
+bool CpuRenderer::addVolume(const std::string &datFile,
+                            const std::string &rawFile,
+                            const glm::vec3 &position, float scale,
+                            int materialIndex) {
+  auto volume = std::make_shared<Volumetric>(
+      datFile, rawFile, toVec3(position), scale,
+      impl_->materialAt(materialIndex));
+  impl_->volumes.push_back(volume);
+  return true;
+}
+
+void CpuRenderer::render(const Camera &camera,
+                         const PushConstants &pushConstants,
+                         std::vector<uint8_t> &outPixels) {
+  impl_->renderFrame(camera, pushConstants, outPixels);
+}
@@ -0,0 +1,135 @@
+#include "SceneFile.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SceneFile::~SceneFile() { close(); }
+
+bool SceneFile::open(const std::string &path) {
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st{};
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    ::close(fd);
+    return false;
+  }
+
+  void *mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+  ::close(fd); // The mapping keeps the file alive
+  if (mapped == MAP_FAILED) {
+    return false;
+  }
+
+  Header header;
+  std::memcpy(&header, mapped, sizeof(Header));
+  if (header.magic != MAGIC || header.version != VERSION) {
+    munmap(mapped, static_cast<size_t>(st.st_size));
+    std::cerr << "Not a valid .ptsc scene: " << path << std::endl;
+    return false;
+  }
+
+  size_t expected = sizeof(Header) +
+                    header.sphereCount * sizeof(GPUSphere) +
+                    header.ellipsoidCount * sizeof(GPUEllipsoid) +
+                    header.materialCount * sizeof(GPUMaterial) +
+                    header.lightCount * sizeof(GPULight) +
+                    header.volumeCount * sizeof(GPUVolumetricData);
+  if (static_cast<size_t>(st.st_size) < expected) {
+    munmap(mapped, static_cast<size_t>(st.st_size));
+    std::cerr << "Truncated .ptsc scene: " << path << std::endl;
+    return false;
+  }
+
+  mapped_ = mapped;
+  mappedSize_ = static_cast<size_t>(st.st_size);
+  header_ = header;
+
+  // Fix up the typed array pointers; the header is 32 bytes and every
+  // record size is a multiple of 16, so each array stays 16-byte aligned
+  const uint8_t *cursor = static_cast<const uint8_t *>(mapped_) +
+                          sizeof(Header);
+  spheres_ = reinterpret_cast<const GPUSphere *>(cursor);
+  cursor += header_.sphereCount * sizeof(GPUSphere);
+  ellipsoids_ = reinterpret_cast<const GPUEllipsoid *>(cursor);
+  cursor += header_.ellipsoidCount * sizeof(GPUEllipsoid);
+  materials_ = reinterpret_cast<const GPUMaterial *>(cursor);
+  cursor += header_.materialCount * sizeof(GPUMaterial);
+  lights_ = reinterpret_cast<const GPULight *>(cursor);
+  cursor += header_.lightCount * sizeof(GPULight);
+  volumes_ = reinterpret_cast<const GPUVolumetricData *>(cursor);
+
+  return true;
+}
+
+void SceneFile::close() {
+  if (mapped_ != nullptr) {
+    munmap(mapped_, mappedSize_);
+    mapped_ = nullptr;
+    mappedSize_ = 0;
+    spheres_ = nullptr;
+    ellipsoids_ = nullptr;
+    materials_ = nullptr;
+    lights_ = nullptr;
+    volumes_ = nullptr;
+  }
+}
+
+bool SceneFile::write(const std::string &path,
+                      const std::vector<GPUSphere> &spheres,
+                      const std::vector<GPUEllipsoid> &ellipsoids,
+                      const std::vector<GPUMaterial> &materials,
+                      const std::vector<GPULight> &lights,
+                      const std::vector<GPUVolumetricData> &volumes) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    std::cerr << "Failed to create scene file: " << path << std::endl;
+    return false;
+  }
+
+  Header header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.sphereCount = static_cast<uint32_t>(spheres.size());
+  header.ellipsoidCount = static_cast<uint32_t>(ellipsoids.size());
+  header.materialCount = static_cast<uint32_t>(materials.size());
+  header.lightCount = static_cast<uint32_t>(lights.size());
+  header.volumeCount = static_cast<uint32_t>(volumes.size());
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+  out.write(reinterpret_cast<const char *>(spheres.data()),
+            static_cast<std::streamsize>(spheres.size() * sizeof(GPUSphere)));
+  out.write(reinterpret_cast<const char *>(ellipsoids.data()),
+            static_cast<std::streamsize>(ellipsoids.size() *
+                                         sizeof(GPUEllipsoid)));
+  out.write(reinterpret_cast<const char *>(materials.data()),
+            static_cast<std::streamsize>(materials.size() *
+                                         sizeof(GPUMaterial)));
+  out.write(reinterpret_cast<const char *>(lights.data()),
+            static_cast<std::streamsize>(lights.size() * sizeof(GPULight)));
+  out.write(reinterpret_cast<const char *>(volumes.data()),
+            static_cast<std::streamsize>(volumes.size() *
+                                         sizeof(GPUVolumetricData)));
+
+  if (!out.good()) {
+    std::cerr << "Failed to write scene file: " << path << std::endl;
+    return false;
+  }
+
+  std::cout << "Baked scene: " << spheres.size() << " spheres, "
+            << ellipsoids.size() << " ellipsoids, " << materials.size()
+            << " materials, " << lights.size() << " lights, "
+            << volumes.size() << " volumes -> " << path << std::endl;
+  return true;
+}
@@ -40,6 +40,22 @@ GPUSphere Sphere::toGPU() const noexcept {
   return gpu;
 }
 
+void Mesh::appendGPUTriangles(std::vector<GPUTriangle> &out) const noexcept {
+  out.reserve(out.size() + indices_.size() / 3);
+  for (size_t i = 0; i + 2 < indices_.size(); i += 3) {
+    if (indices_[i] >= vertices_.size() || indices_[i + 1] >= vertices_.size() ||
+        indices_[i + 2] >= vertices_.size()) {
+      continue;
+    }
+    GPUTriangle tri{};
+    tri.v0 = vertices_[indices_[i]];
+    tri.v1 = vertices_[indices_[i + 1]];
+    tri.v2 = vertices_[indices_[i + 2]];
+    tri.materialIndex = materialIndex_;
+    out.push_back(tri);
+  }
+}
+
 GPULight Light::toGPU() const noexcept {
   GPULight gpu{};
   gpu.position = position_;
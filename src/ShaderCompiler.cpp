@@ -1,4 +1,5 @@
 #include "ShaderCompiler.h"
+#include <cstdio>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
@@ -36,6 +37,61 @@ std::string ShaderCompiler::getShaderStageName(VkShaderStageFlagBits stage)
   }
 }
 
+uint64_t ShaderCompiler::hashShaderSource(const std::string &source)
+{
+  // FNV-1a 64-bit
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : source)
+  {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::vector<uint32_t>
+ShaderCompiler::compileShaderSourceCached(const std::string &shaderSource,
+                                          const std::string &tempShaderPath,
+                                          const std::string &cacheDir)
+{
+  std::error_code ec;
+  fs::create_directories(cacheDir, ec);
+
+  char hashHex[17];
+  snprintf(hashHex, sizeof(hashHex), "%016llx",
+           (unsigned long long)hashShaderSource(shaderSource));
+  std::string cachedSpirvPath = cacheDir + "/" + hashHex + ".spv";
+
+  if (fs::exists(cachedSpirvPath))
+  {
+    std::cout << "Using cached SPIR-V: " << cachedSpirvPath << std::endl;
+    return readSPIRVFile(cachedSpirvPath);
+  }
+
+  // Cache miss - write the composed source and shell out to glslc once
+  std::ofstream tempFile(tempShaderPath);
+  if (!tempFile.is_open())
+  {
+    throw std::runtime_error("Failed to write temporary shader file: " +
+                             tempShaderPath);
+  }
+  tempFile << shaderSource;
+  tempFile.close();
+
+  std::vector<uint32_t> spirv = compileWithGlslc(tempShaderPath);
+
+  // Store the result for the next run
+  fs::copy_file(tempShaderPath + ".spv", cachedSpirvPath,
+                fs::copy_options::overwrite_existing, ec);
+  if (ec)
+  {
+    std::cout << "Warning: failed to populate SPIR-V cache at "
+              << cachedSpirvPath << std::endl;
+  }
+
+  return spirv;
+}
+
 std::vector<uint32_t>
 ShaderCompiler::compileWithGlslc(const std::string &shaderPath)
 {
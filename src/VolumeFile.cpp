@@ -0,0 +1,227 @@
+#include "VolumeFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Spread the low 10 bits of v so there are two zero bits between each
+uint64_t part1By2(uint32_t v) {
+  uint64_t x = v & 0x3FF;
+  x = (x | (x << 16)) & 0x030000FF;
+  x = (x | (x << 8)) & 0x0300F00F;
+  x = (x | (x << 4)) & 0x030C30C3;
+  x = (x | (x << 2)) & 0x09249249;
+  return x;
+}
+
+uint32_t nextPowerOfTwo(uint32_t v) {
+  uint32_t p = 1;
+  while (p < v) {
+    p <<= 1;
+  }
+  return p;
+}
+
+} // namespace
+
+uint64_t VolumeFile::mortonIndex(uint32_t x, uint32_t y, uint32_t z) {
+  return part1By2(x) | (part1By2(y) << 1) | (part1By2(z) << 2);
+}
+
+VolumeFile::~VolumeFile() { close(); }
+
+bool VolumeFile::open(const std::string &path) {
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st{};
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    ::close(fd);
+    return false;
+  }
+
+  // MAP_PRIVATE read-only: pages stream in on first touch, holes read as
+  // zeros without touching the disk
+  void *mapped =
+      mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE,
+           fd, 0);
+  ::close(fd); // The mapping keeps the file alive
+  if (mapped == MAP_FAILED) {
+    return false;
+  }
+
+  Header header;
+  std::memcpy(&header, mapped, sizeof(Header));
+  if (header.magic != MAGIC || header.version != VERSION ||
+      header.brickSize != BRICK_SIZE) {
+    munmap(mapped, static_cast<size_t>(st.st_size));
+    std::cerr << "Not a valid .ptvb volume: " << path << std::endl;
+    return false;
+  }
+
+  mapped_ = mapped;
+  mappedSize_ = static_cast<size_t>(st.st_size);
+  header_ = header;
+  return true;
+}
+
+void VolumeFile::close() {
+  if (mapped_ != nullptr) {
+    munmap(mapped_, mappedSize_);
+    mapped_ = nullptr;
+    mappedSize_ = 0;
+  }
+}
+
+glm::ivec3 VolumeFile::resolution() const {
+  return glm::ivec3(header_.resolution[0], header_.resolution[1],
+                    header_.resolution[2]);
+}
+
+glm::ivec3 VolumeFile::brickCount() const {
+  return glm::ivec3(header_.brickCount[0], header_.brickCount[1],
+                    header_.brickCount[2]);
+}
+
+const uint8_t *VolumeFile::brickData(int bx, int by, int bz) const {
+  size_t offset = sizeof(Header) + mortonIndex(static_cast<uint32_t>(bx),
+                                               static_cast<uint32_t>(by),
+                                               static_cast<uint32_t>(bz)) *
+                                       BRICK_BYTES;
+  return static_cast<const uint8_t *>(mapped_) + offset;
+}
+
+bool VolumeFile::brickOccupied(int bx, int by, int bz) const {
+  const uint8_t *brick = brickData(bx, by, bz);
+  for (size_t i = 0; i < BRICK_BYTES; i++) {
+    if (brick[i] != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool VolumeFile::convert(const std::string &rawPath, glm::ivec3 resolution,
+                         const std::string &outPath) {
+  std::ifstream raw(rawPath, std::ios::binary);
+  if (!raw.is_open()) {
+    std::cerr << "Failed to open raw volume: " << rawPath << std::endl;
+    return false;
+  }
+
+  glm::ivec3 bricks((resolution.x + BRICK_SIZE - 1) / BRICK_SIZE,
+                    (resolution.y + BRICK_SIZE - 1) / BRICK_SIZE,
+                    (resolution.z + BRICK_SIZE - 1) / BRICK_SIZE);
+
+  // File spans the power-of-two padded Morton cube; only written bricks
+  // take up disk space
+  uint32_t pad = nextPowerOfTwo(static_cast<uint32_t>(
+      std::max(bricks.x, std::max(bricks.y, bricks.z))));
+  size_t fileSize = sizeof(Header) +
+                    static_cast<size_t>(pad) * pad * pad * BRICK_BYTES;
+
+  int fd = ::open(outPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 || ftruncate(fd, static_cast<off_t>(fileSize)) != 0) {
+    std::cerr << "Failed to create output volume: " << outPath << std::endl;
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    return false;
+  }
+
+  Header header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.resolution[0] = static_cast<uint32_t>(resolution.x);
+  header.resolution[1] = static_cast<uint32_t>(resolution.y);
+  header.resolution[2] = static_cast<uint32_t>(resolution.z);
+  header.brickSize = BRICK_SIZE;
+  header.brickCount[0] = static_cast<uint32_t>(bricks.x);
+  header.brickCount[1] = static_cast<uint32_t>(bricks.y);
+  header.brickCount[2] = static_cast<uint32_t>(bricks.z);
+  if (pwrite(fd, &header, sizeof(header), 0) !=
+      static_cast<ssize_t>(sizeof(header))) {
+    ::close(fd);
+    return false;
+  }
+
+  // One brick-slab (BRICK_SIZE slices) of the source in memory at a time
+  size_t sliceBytes = static_cast<size_t>(resolution.x) * resolution.y;
+  std::vector<uint8_t> slab(sliceBytes * BRICK_SIZE);
+  std::vector<uint8_t> brick(BRICK_BYTES);
+  size_t bricksWritten = 0;
+
+  for (int bz = 0; bz < bricks.z; bz++) {
+    int slabZ = std::min(BRICK_SIZE, resolution.z - bz * BRICK_SIZE);
+    raw.read(reinterpret_cast<char *>(slab.data()),
+             static_cast<std::streamsize>(sliceBytes * slabZ));
+    if (raw.gcount() != static_cast<std::streamsize>(sliceBytes * slabZ)) {
+      std::cerr << "Short read converting " << rawPath << std::endl;
+      ::close(fd);
+      return false;
+    }
+
+    for (int by = 0; by < bricks.y; by++) {
+      for (int bx = 0; bx < bricks.x; bx++) {
+        int sizeX = std::min(BRICK_SIZE, resolution.x - bx * BRICK_SIZE);
+        int sizeY = std::min(BRICK_SIZE, resolution.y - by * BRICK_SIZE);
+
+        std::fill(brick.begin(), brick.end(), 0);
+        bool occupied = false;
+        for (int z = 0; z < slabZ; z++) {
+          for (int y = 0; y < sizeY; y++) {
+            const uint8_t *src = slab.data() + static_cast<size_t>(z) * sliceBytes +
+                                 (static_cast<size_t>(by) * BRICK_SIZE + y) *
+                                     resolution.x +
+                                 static_cast<size_t>(bx) * BRICK_SIZE;
+            uint8_t *dst = brick.data() +
+                           (static_cast<size_t>(z) * BRICK_SIZE + y) *
+                               BRICK_SIZE;
+            std::memcpy(dst, src, sizeX);
+            for (int x = 0; x < sizeX && !occupied; x++) {
+              occupied = src[x] != 0;
+            }
+          }
+        }
+
+        // Empty bricks stay holes: no disk usage, mapped reads return zeros
+        if (!occupied) {
+          continue;
+        }
+
+        off_t offset = static_cast<off_t>(
+            sizeof(Header) + mortonIndex(static_cast<uint32_t>(bx),
+                                         static_cast<uint32_t>(by),
+                                         static_cast<uint32_t>(bz)) *
+                                 BRICK_BYTES);
+        if (pwrite(fd, brick.data(), BRICK_BYTES, offset) !=
+            static_cast<ssize_t>(BRICK_BYTES)) {
+          std::cerr << "Short write converting " << rawPath << std::endl;
+          ::close(fd);
+          return false;
+        }
+        bricksWritten++;
+      }
+    }
+  }
+
+  ::close(fd);
+  std::cout << "Converted " << rawPath << " to " << outPath << ": "
+            << bricksWritten << " occupied of "
+            << static_cast<size_t>(bricks.x) * bricks.y * bricks.z
+            << " bricks" << std::endl;
+  return true;
+}
@@ -1,7 +1,10 @@
 #include <Volumetric.h>
+#include <algorithm>
 #include <cmath>
+#include <execution>
 #include <fstream>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 
 Volumetric::Volumetric(std::string datFile, std::string rawFile, Vec3 position,
@@ -68,6 +71,43 @@ Volumetric::Volumetric(std::string datFile, std::string rawFile, Vec3 position,
   } else {
     std::cerr << "Failed to load volumetric data from " << rawFile << std::endl;
   }
+
+  // Shading queries hit GetNormal once per ray, so bake the gradient field
+  // up front instead of doing six density lookups per query
+  _gradients = new int8_t[len * 3];
+  BuildGradientField();
+}
+
+Volumetric::~Volumetric() {
+  delete[] _data;
+  delete[] _gradients;
+}
+
+void Volumetric::BuildGradientField() {
+  // Central-difference gradient per voxel, normalized and packed as snorm8.
+  // GetNormal normalizes anyway, so only the direction is kept. Parallel
+  // over z slices; each slice only reads density, so slices are independent.
+  std::vector<int> slices(_resolution[2]);
+  std::iota(slices.begin(), slices.end(), 0);
+  std::for_each(
+      std::execution::par_unseq, slices.begin(), slices.end(), [this](int z) {
+        for (int y = 0; y < _resolution[1]; y++) {
+          for (int x = 0; x < _resolution[0]; x++) {
+            double gx = (double)Value(x + 1, y, z) - Value(x - 1, y, z);
+            double gy = (double)Value(x, y + 1, z) - Value(x, y - 1, z);
+            double gz = (double)Value(x, y, z + 1) - Value(x, y, z - 1);
+            Vec3 g = Vec3(gx, gy, gz).normalized();
+
+            long long idx =
+                ((long long)z * _resolution[1] * _resolution[0] +
+                 (long long)y * _resolution[0] + x) *
+                3;
+            _gradients[idx] = (int8_t)std::lround(g.x * 127.0);
+            _gradients[idx + 1] = (int8_t)std::lround(g.y * 127.0);
+            _gradients[idx + 2] = (int8_t)std::lround(g.z * 127.0);
+          }
+        }
+      });
 }
 
 bool Volumetric::hit(const Ray &ray, double tMin, double tMax,
@@ -173,15 +213,23 @@ Vec3 Volumetric::GetIndexes(Vec3 v) const {
 }
 
 Vec3 Volumetric::GetNormal(Vec3 v) const {
+  // Single fetch from the precomputed field (see BuildGradientField);
+  // re-normalize to undo the snorm8 quantization
   Vec3 idx = GetIndexes(v);
-  double x0 = Value(idx.x - 1, idx.y, idx.z);
-  double x1 = Value(idx.x + 1, idx.y, idx.z);
-  double y0 = Value(idx.x, idx.y - 1, idx.z);
-  double y1 = Value(idx.x, idx.y + 1, idx.z);
-  double z0 = Value(idx.x, idx.y, idx.z - 1);
-  double z1 = Value(idx.x, idx.y, idx.z + 1);
-
-  return Vec3(x1 - x0, y1 - y0, z1 - z0).normalized();
+  int x = (int)idx.x;
+  int y = (int)idx.y;
+  int z = (int)idx.z;
+  if (x < 0 || y < 0 || z < 0 || x >= _resolution[0] || y >= _resolution[1] ||
+      z >= _resolution[2]) {
+    return Vec3(0, 0, 0);
+  }
+
+  long long offset = ((long long)z * _resolution[1] * _resolution[0] +
+                      (long long)y * _resolution[0] + x) *
+                     3;
+  return Vec3(_gradients[offset], _gradients[offset + 1],
+              _gradients[offset + 2])
+      .normalized();
 }
 
 double Volumetric::getDensity(const Vec3 &point) const {
@@ -1,12 +1,19 @@
 #include "VulkanRenderer.h"
+#include "BVH.h"
 #include "ShaderCompiler.h"
+#include "VolumeFile.h"
 #include <SDL3/SDL_vulkan.h>
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
 #include <cstring>
 #include <execution>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
 
 // Helper function for memory type lookup
 uint32_t findMemoryType(VkPhysicalDeviceMemoryProperties props,
@@ -27,6 +34,8 @@ VulkanRenderer::~VulkanRenderer() { shutdown(); }
 bool VulkanRenderer::initialize(SDL_Window *window, int width, int height) {
   windowWidth = width;
   windowHeight = height;
+  renderWidth_ = width;
+  renderHeight_ = height;
 
   if (!createInstance()) {
     std::cerr << "Failed to create Vulkan instance" << std::endl;
@@ -68,6 +77,9 @@ bool VulkanRenderer::initialize(SDL_Window *window, int width, int height) {
     return false;
   }
 
+  // Buffers and output image exist now; point the descriptor set at them
+  refreshDescriptorSets();
+
   return true;
 }
 
@@ -210,6 +222,16 @@ bool VulkanRenderer::selectPhysicalDevice() {
         // Prefer DEVICE_LOCAL buffers with staging on discrete GPUs
         useDeviceLocalBuffers = (deviceProperties.deviceType ==
                                  VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU);
+
+        // Timestamp queries need a nonzero valid-bit count on the compute
+        // queue family and a known tick period
+        timestampPeriodNs = deviceProperties.limits.timestampPeriod;
+        timestampsSupported =
+            queueFamilies[i].timestampValidBits > 0 && timestampPeriodNs > 0.0f;
+        if (!timestampsSupported) {
+          std::cout << "Timestamp queries unsupported; GPU timings disabled"
+                    << std::endl;
+        }
         return true;
       }
     }
@@ -228,20 +250,38 @@ bool VulkanRenderer::createLogicalDevice() {
                                            queueFamilies.data());
 
   // Find compute queue family
-  uint32_t computeQueueFamily = 0;
+  computeQueueFamilyIndex = 0;
   for (uint32_t i = 0; i < queueFamilyCount; i++) {
     if (queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) {
-      computeQueueFamily = i;
+      computeQueueFamilyIndex = i;
+      break;
+    }
+  }
+
+  // Prefer a dedicated transfer family (TRANSFER without GRAPHICS/COMPUTE -
+  // the DMA engines on discrete GPUs) for scene uploads; fall back to the
+  // compute family when there is none
+  transferQueueFamilyIndex = computeQueueFamilyIndex;
+  for (uint32_t i = 0; i < queueFamilyCount; i++) {
+    if ((queueFamilies[i].queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+        !(queueFamilies[i].queueFlags &
+          (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+      transferQueueFamilyIndex = i;
       break;
     }
   }
 
   float queuePriority = 1.0f;
-  VkDeviceQueueCreateInfo queueCreateInfo{};
-  queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-  queueCreateInfo.queueFamilyIndex = computeQueueFamily;
-  queueCreateInfo.queueCount = 1;
-  queueCreateInfo.pQueuePriorities = &queuePriority;
+  VkDeviceQueueCreateInfo queueCreateInfos[2]{};
+  queueCreateInfos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+  queueCreateInfos[0].queueFamilyIndex = computeQueueFamilyIndex;
+  queueCreateInfos[0].queueCount = 1;
+  queueCreateInfos[0].pQueuePriorities = &queuePriority;
+  queueCreateInfos[1] = queueCreateInfos[0];
+  queueCreateInfos[1].queueFamilyIndex = transferQueueFamilyIndex;
+
+  uint32_t queueCreateInfoCount =
+      (transferQueueFamilyIndex != computeQueueFamilyIndex) ? 2 : 1;
 
   // Device extensions for AMD RT optimization
   std::vector<const char *> deviceExtensions;
@@ -267,8 +307,8 @@ bool VulkanRenderer::createLogicalDevice() {
 
   VkDeviceCreateInfo deviceCreateInfo{};
   deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-  deviceCreateInfo.queueCreateInfoCount = 1;
-  deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+  deviceCreateInfo.queueCreateInfoCount = queueCreateInfoCount;
+  deviceCreateInfo.pQueueCreateInfos = queueCreateInfos;
   deviceCreateInfo.pNext = &deviceFeatures2;
   deviceCreateInfo.enabledExtensionCount =
       static_cast<uint32_t>(deviceExtensions.size());
@@ -279,32 +319,22 @@ bool VulkanRenderer::createLogicalDevice() {
     return false;
   }
 
-  vkGetDeviceQueue(vkDevice, computeQueueFamily, 0, &vkComputeQueue);
+  vkGetDeviceQueue(vkDevice, computeQueueFamilyIndex, 0, &vkComputeQueue);
+  vkGetDeviceQueue(vkDevice, transferQueueFamilyIndex, 0, &vkTransferQueue);
+
+  if (transferQueueFamilyIndex != computeQueueFamilyIndex) {
+    std::cout << "Using dedicated transfer queue family "
+              << transferQueueFamilyIndex << " for scene uploads" << std::endl;
+  }
 
   std::cout << "Logical device created successfully" << std::endl;
   return true;
 }
 
 bool VulkanRenderer::createCommandPool() {
-  uint32_t queueFamilyCount = 0;
-  vkGetPhysicalDeviceQueueFamilyProperties(vkPhysicalDevice, &queueFamilyCount,
-                                           nullptr);
-
-  std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
-  vkGetPhysicalDeviceQueueFamilyProperties(vkPhysicalDevice, &queueFamilyCount,
-                                           queueFamilies.data());
-
-  uint32_t computeQueueFamily = 0;
-  for (uint32_t i = 0; i < queueFamilyCount; i++) {
-    if (queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) {
-      computeQueueFamily = i;
-      break;
-    }
-  }
-
   VkCommandPoolCreateInfo poolInfo{};
   poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-  poolInfo.queueFamilyIndex = computeQueueFamily;
+  poolInfo.queueFamilyIndex = computeQueueFamilyIndex;
   poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
   if (vkCreateCommandPool(vkDevice, &poolInfo, nullptr, &vkCommandPool) !=
@@ -312,6 +342,16 @@ bool VulkanRenderer::createCommandPool() {
     return false;
   }
 
+  // Upload command buffers get their own pool on the transfer family so they
+  // can be submitted to the transfer queue
+  VkCommandPoolCreateInfo transferPoolInfo = poolInfo;
+  transferPoolInfo.queueFamilyIndex = transferQueueFamilyIndex;
+
+  if (vkCreateCommandPool(vkDevice, &transferPoolInfo, nullptr,
+                          &vkTransferCommandPool) != VK_SUCCESS) {
+    return false;
+  }
+
   // Allocate multiple command buffers for frames in flight
   VkCommandBufferAllocateInfo allocInfo{};
   allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -324,6 +364,36 @@ bool VulkanRenderer::createCommandPool() {
     return false;
   }
 
+  // Per-frame command buffers for batched scene uploads (transfer pool) and
+  // for the swapchain blit, so neither has to be reallocated or drained per
+  // frame
+  VkCommandBufferAllocateInfo uploadAllocInfo{};
+  uploadAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  uploadAllocInfo.commandPool = vkTransferCommandPool;
+  uploadAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  uploadAllocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
+
+  VkCommandBufferAllocateInfo blitAllocInfo = uploadAllocInfo;
+  blitAllocInfo.commandPool = vkCommandPool;
+
+  if (vkAllocateCommandBuffers(vkDevice, &uploadAllocInfo,
+                               vkUploadCommandBuffers) != VK_SUCCESS ||
+      vkAllocateCommandBuffers(vkDevice, &blitAllocInfo,
+                               vkBlitCommandBuffers) != VK_SUCCESS) {
+    return false;
+  }
+
+  // Semaphores that order each frame's upload batch before its compute
+  // dispatch without draining the queue
+  VkSemaphoreCreateInfo semaphoreInfo{};
+  semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    if (vkCreateSemaphore(vkDevice, &semaphoreInfo, nullptr,
+                          &vkUploadSemaphores[i]) != VK_SUCCESS) {
+      return false;
+    }
+  }
+
   // Create fences for synchronization (start signaled so first frame doesn't
   // wait)
   VkFenceCreateInfo fenceInfo{};
@@ -337,11 +407,61 @@ bool VulkanRenderer::createCommandPool() {
     }
   }
 
+  // Timestamp query pool: a begin/end pair per stage (upload, compute, blit)
+  // per frame slot
+  if (timestampsSupported) {
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = MAX_FRAMES_IN_FLIGHT * TIMING_STAGE_COUNT * 2;
+
+    if (vkCreateQueryPool(vkDevice, &queryPoolInfo, nullptr,
+                          &vkTimestampQueryPool) != VK_SUCCESS) {
+      std::cerr << "Failed to create timestamp query pool; GPU timings disabled"
+                << std::endl;
+      timestampsSupported = false;
+    }
+  }
+
+  // Upload timing needs vkCmdResetQueryPool, which a pure transfer queue
+  // can't record; with a dedicated transfer family only compute and blit
+  // stages are instrumented
+  uploadTimestampsSupported =
+      timestampsSupported && transferQueueFamilyIndex == computeQueueFamilyIndex;
+
   std::cout << "Command pool created successfully with " << MAX_FRAMES_IN_FLIGHT
             << " command buffers" << std::endl;
   return true;
 }
 
+// First two dimensions of the Sobol sequence in Gray-code order: dimension 0
+// is the base-2 radical inverse, dimension 1 uses the standard degree-1
+// direction-number recurrence
+static std::vector<glm::vec2> generateSobolSequence(int count) {
+  uint32_t v1[32];
+  v1[0] = 1u << 31;
+  for (int bit = 1; bit < 32; bit++) {
+    v1[bit] = v1[bit - 1] ^ (v1[bit - 1] >> 1);
+  }
+
+  std::vector<glm::vec2> points(count);
+  points[0] = glm::vec2(0.0f);
+  uint32_t x = 0;
+  uint32_t y = 0;
+  for (int i = 1; i < count; i++) {
+    // Gray-code step: flip the direction number of the lowest zero bit of i-1
+    int c = 0;
+    for (int n = i - 1; n & 1; n >>= 1) {
+      c++;
+    }
+    x ^= 1u << (31 - c);
+    y ^= v1[c];
+    points[i] = glm::vec2(static_cast<float>(x), static_cast<float>(y)) *
+                (1.0f / 4294967296.0f);
+  }
+  return points;
+}
+
 bool VulkanRenderer::createBuffers() {
   // For now, create minimal buffers - will be resized during updateScene
   // Sphere buffer needs 2 vec4s per sphere (center+radius, then
@@ -398,6 +518,16 @@ bool VulkanRenderer::createBuffers() {
     return false;
   }
 
+  // Low-discrepancy sample sequence, written once below and never rewritten
+  if (!createBuffer(SAMPLE_SEQUENCE_LENGTH * sizeof(glm::vec2), storageUsage,
+                    useDeviceLocalBuffers
+                        ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                        : (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                           VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+                    vkSampleBuffer, vkSampleBufferMemory)) {
+    return false;
+  }
+
   if (!createBuffer(volumeBufferSize, storageUsage,
                     useDeviceLocalBuffers
                         ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
@@ -407,24 +537,399 @@ bool VulkanRenderer::createBuffers() {
     return false;
   }
 
-  // Voxel data buffer (for actual volumetric CT data)
-  size_t voxelDataBufferSize = 50 * 1024 * 1024; // 50MB for voxel data
-  if (!createBuffer(voxelDataBufferSize, storageUsage,
+  // Triangle buffer; updateTriangles grows it on demand for large meshes
+  triangleBufferCapacity_ = 4096;
+  if (!createBuffer(triangleBufferCapacity_ * sizeof(GPUTriangle),
+                    storageUsage,
+                    useDeviceLocalBuffers
+                        ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                        : (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                           VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+                    vkTriangleBuffer, vkTriangleBufferMemory)) {
+    return false;
+  }
+
+  // Volume density sampler (trilinear, clamp to edge) - shared by the
+  // placeholder and the real density image
+  VkSamplerCreateInfo samplerInfo{};
+  samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  samplerInfo.magFilter = VK_FILTER_LINEAR;
+  samplerInfo.minFilter = VK_FILTER_LINEAR;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+
+  if (vkCreateSampler(vkDevice, &samplerInfo, nullptr,
+                      &vkVolumeDensitySampler) != VK_SUCCESS) {
+    return false;
+  }
+
+  // 1x1x1 placeholder density image so the descriptor set is valid before
+  // the first voxel upload (the resource helper clears it to zero)
+  if (!createVolumeDensityImageResource(1, 1, 1)) {
+    return false;
+  }
+
+  // Brick occupancy grid for empty-space skipping during ray marching
+  // (1MB covers ~260k bricks; a 400x296x352 volume at 8^3 bricks needs ~82k)
+  size_t occupancyBufferSize = 1024 * 1024;
+  if (!createBuffer(occupancyBufferSize, storageUsage,
+                    useDeviceLocalBuffers
+                        ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                        : (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                           VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+                    vkOccupancyBuffer, vkOccupancyBufferMemory)) {
+    return false;
+  }
+
+  // BVH node and primitive index buffers (rebuilt from spheres + ellipsoids
+  // in updateScene)
+  size_t bvhNodeBufferSize = sizeof(GPUBVHNode) * 1024;
+  size_t bvhIndexBufferSize = sizeof(uint32_t) * 2048;
+  if (!createBuffer(bvhNodeBufferSize, storageUsage,
+                    useDeviceLocalBuffers
+                        ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                        : (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                           VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+                    vkBVHNodeBuffer, vkBVHNodeBufferMemory)) {
+    return false;
+  }
+
+  if (!createBuffer(bvhIndexBufferSize, storageUsage,
                     useDeviceLocalBuffers
                         ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
                         : (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
-                    vkVoxelDataBuffer, vkVoxelDataBufferMemory)) {
+                    vkBVHIndexBuffer, vkBVHIndexBufferMemory)) {
     return false;
   }
 
+  // Persistently-mapped staging ring for per-frame uploads (only needed when
+  // we stage into DEVICE_LOCAL buffers)
+  if (useDeviceLocalBuffers) {
+    VkDeviceSize ringSize = STAGING_REGION_SIZE * MAX_FRAMES_IN_FLIGHT;
+    if (!createBuffer(ringSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                      vkStagingRingBuffer, vkStagingRingMemory)) {
+      return false;
+    }
+    stagingRingMapped = arenaMappedPtr(vkStagingRingBuffer);
+    if (stagingRingMapped == nullptr) {
+      return false;
+    }
+  }
+
+  // Seed the static Sobol sequence and zero the occupancy header so the
+  // shader sees "no grid" until the first voxel upload
+  std::vector<glm::vec2> sobol = generateSobolSequence(SAMPLE_SEQUENCE_LENGTH);
+  VkDeviceSize sobolSize = sobol.size() * sizeof(glm::vec2);
+  uint32_t zeroHeader[4] = {0, 0, 0, 0};
+  if (useDeviceLocalBuffers) {
+    stageUpload(vkSampleBuffer, sobol.data(), sobolSize);
+    stageUpload(vkOccupancyBuffer, zeroHeader, sizeof(zeroHeader));
+    flushSceneUpload(true);
+  } else {
+    std::memcpy(arenaMappedPtr(vkSampleBuffer), sobol.data(), sobolSize);
+    std::memcpy(arenaMappedPtr(vkOccupancyBuffer), zeroHeader,
+                sizeof(zeroHeader));
+  }
+
   std::cout << "Storage buffers created successfully" << std::endl;
   return true;
 }
 
+void VulkanRenderer::beginSceneUpload() {
+  if (uploadRecording) {
+    return;
+  }
+
+  // Make sure this frame slot's previous work (upload + compute + blit) has
+  // retired before reusing its ring region and command buffer. The fence is
+  // not reset here; render() does that when it takes the slot.
+  vkWaitForFences(vkDevice, 1, &vkInFlightFences[currentFrame], VK_TRUE,
+                  UINT64_MAX);
+
+  for (auto &[stagingBuf, stagingMem] : retiredStagingBuffers[currentFrame]) {
+    destroyArenaBuffer(stagingBuf, stagingMem);
+  }
+  retiredStagingBuffers[currentFrame].clear();
+
+  // The slot's last results are complete now; read them before the rewrite
+  // below resets the slot's queries
+  collectGpuTimings(currentFrame);
+
+  stagingRingCursor = 0;
+
+  vkResetCommandBuffer(vkUploadCommandBuffers[currentFrame], 0);
+
+  VkCommandBufferBeginInfo beginInfo{};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(vkUploadCommandBuffers[currentFrame], &beginInfo);
+  uploadRecording = true;
+
+  if (uploadTimestampsSupported) {
+    uint32_t query = timingQueryIndex(currentFrame, TIMING_STAGE_UPLOAD);
+    vkCmdResetQueryPool(vkUploadCommandBuffers[currentFrame],
+                        vkTimestampQueryPool, query, 2);
+    vkCmdWriteTimestamp(vkUploadCommandBuffers[currentFrame],
+                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        vkTimestampQueryPool, query);
+  }
+}
+
+bool VulkanRenderer::stageUpload(VkBuffer dst, const void *src,
+                                 VkDeviceSize size) {
+  beginSceneUpload();
+
+  // Suballocate from this frame's ring region (16-byte aligned)
+  VkDeviceSize base = currentFrame * STAGING_REGION_SIZE;
+  VkDeviceSize aligned = (stagingRingCursor + 15) & ~VkDeviceSize(15);
+
+  if (aligned + size <= STAGING_REGION_SIZE) {
+    std::memcpy(static_cast<uint8_t *>(stagingRingMapped) + base + aligned, src,
+                size);
+
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = base + aligned;
+    copyRegion.dstOffset = 0;
+    copyRegion.size = size;
+    vkCmdCopyBuffer(vkUploadCommandBuffers[currentFrame],
+                    vkStagingRingBuffer, dst, 1, &copyRegion);
+
+    stagingRingCursor = aligned + size;
+    return true;
+  }
+
+  // Upload too large for the ring region (e.g. initial voxel data) - fall
+  // back to a one-shot staging buffer released after the batched submit
+  VkBuffer stagingBuf;
+  VkDeviceMemory stagingMem;
+  if (!createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                    stagingBuf, stagingMem)) {
+    return false;
+  }
+
+  std::memcpy(arenaMappedPtr(stagingBuf), src, size);
+
+  VkBufferCopy copyRegion{};
+  copyRegion.srcOffset = 0;
+  copyRegion.dstOffset = 0;
+  copyRegion.size = size;
+  vkCmdCopyBuffer(vkUploadCommandBuffers[currentFrame], stagingBuf, dst, 1,
+                  &copyRegion);
+
+  pendingStagingBuffers.emplace_back(stagingBuf, stagingMem);
+  return true;
+}
+
+void VulkanRenderer::flushSceneUpload(bool blocking) {
+  if (!uploadRecording) {
+    return;
+  }
+
+  if (uploadTimestampsSupported) {
+    vkCmdWriteTimestamp(vkUploadCommandBuffers[currentFrame],
+                        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        vkTimestampQueryPool,
+                        timingQueryIndex(currentFrame, TIMING_STAGE_UPLOAD) +
+                            1);
+    timingQueryIssued[currentFrame][TIMING_STAGE_UPLOAD] = true;
+  }
+
+  vkEndCommandBuffer(vkUploadCommandBuffers[currentFrame]);
+
+  VkSubmitInfo submitInfo{};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &vkUploadCommandBuffers[currentFrame];
+
+  if (blocking) {
+    // Init-time path: drain the queue so the caller can immediately use the
+    // uploaded data (e.g. to rewrite descriptors)
+    vkQueueSubmit(vkTransferQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    vkQueueWaitIdle(vkTransferQueue);
+
+    for (auto &[stagingBuf, stagingMem] : pendingStagingBuffers) {
+      destroyArenaBuffer(stagingBuf, stagingMem);
+    }
+    pendingStagingBuffers.clear();
+  } else {
+    // Per-frame path: signal the upload semaphore and let this frame's
+    // compute submit wait on it. On devices with a dedicated transfer family
+    // the copies run on the DMA engine, overlapping the previous frame's
+    // tracing on the compute queue.
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &vkUploadSemaphores[currentFrame];
+
+    vkQueueSubmit(vkTransferQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    uploadWaitPending = true;
+
+    // One-shot staging buffers stay alive until this frame slot's fence has
+    // been waited on again
+    auto &retired = retiredStagingBuffers[currentFrame];
+    retired.insert(retired.end(), pendingStagingBuffers.begin(),
+                   pendingStagingBuffers.end());
+    pendingStagingBuffers.clear();
+  }
+
+  uploadRecording = false;
+}
+
+bool VulkanRenderer::createVolumeDensityImageResource(int resX, int resY,
+                                                      int resZ) {
+  // Replacing an existing image - make sure no in-flight frame samples it
+  if (vkVolumeDensityImage != VK_NULL_HANDLE) {
+    vkDeviceWaitIdle(vkDevice);
+    vkDestroyImageView(vkDevice, vkVolumeDensityImageView, nullptr);
+    vkDestroyImage(vkDevice, vkVolumeDensityImage, nullptr);
+    vkFreeMemory(vkDevice, vkVolumeDensityImageMemory, nullptr);
+    vkVolumeDensityImageView = VK_NULL_HANDLE;
+    vkVolumeDensityImage = VK_NULL_HANDLE;
+    vkVolumeDensityImageMemory = VK_NULL_HANDLE;
+  }
+
+  VkImageCreateInfo imageInfo{};
+  imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  imageInfo.imageType = VK_IMAGE_TYPE_3D;
+  imageInfo.format = VK_FORMAT_R8_UNORM;
+  imageInfo.extent = {static_cast<uint32_t>(resX), static_cast<uint32_t>(resY),
+                      static_cast<uint32_t>(resZ)};
+  imageInfo.mipLevels = 1;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage =
+      VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  // Written by the transfer queue, sampled by the compute queue
+  uint32_t shareFamilies[2] = {computeQueueFamilyIndex,
+                               transferQueueFamilyIndex};
+  if (transferQueueFamilyIndex != computeQueueFamilyIndex) {
+    imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    imageInfo.queueFamilyIndexCount = 2;
+    imageInfo.pQueueFamilyIndices = shareFamilies;
+  }
+
+  if (vkCreateImage(vkDevice, &imageInfo, nullptr, &vkVolumeDensityImage) !=
+      VK_SUCCESS) {
+    std::cerr << "Failed to create 3D volume density image" << std::endl;
+    return false;
+  }
+
+  VkMemoryRequirements memReqs;
+  vkGetImageMemoryRequirements(vkDevice, vkVolumeDensityImage, &memReqs);
+
+  VkMemoryAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = memReqs.size;
+  allocInfo.memoryTypeIndex =
+      findMemoryType(memoryProperties, memReqs.memoryTypeBits,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+  if (vkAllocateMemory(vkDevice, &allocInfo, nullptr,
+                       &vkVolumeDensityImageMemory) != VK_SUCCESS ||
+      vkBindImageMemory(vkDevice, vkVolumeDensityImage,
+                        vkVolumeDensityImageMemory, 0) != VK_SUCCESS) {
+    return false;
+  }
+
+  VkImageViewCreateInfo viewInfo{};
+  viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+  viewInfo.image = vkVolumeDensityImage;
+  viewInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
+  viewInfo.format = VK_FORMAT_R8_UNORM;
+  viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  viewInfo.subresourceRange.baseMipLevel = 0;
+  viewInfo.subresourceRange.levelCount = 1;
+  viewInfo.subresourceRange.baseArrayLayer = 0;
+  viewInfo.subresourceRange.layerCount = 1;
+
+  if (vkCreateImageView(vkDevice, &viewInfo, nullptr,
+                        &vkVolumeDensityImageView) != VK_SUCCESS) {
+    return false;
+  }
+
+  // Clear to zero and leave the image in the sampled layout, so volumes
+  // whose density hasn't been uploaded yet read as empty space. This is a
+  // one-shot submit on the compute queue: vkCmdClearColorImage and
+  // shader-stage barriers are both invalid on a pure transfer queue.
+  {
+    VkCommandBufferAllocateInfo cmdAllocInfo{};
+    cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    cmdAllocInfo.commandPool = vkCommandPool;
+    cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAllocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer cmd;
+    if (vkAllocateCommandBuffers(vkDevice, &cmdAllocInfo, &cmd) !=
+        VK_SUCCESS) {
+      return false;
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = vkVolumeDensityImage;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+
+    VkClearColorValue zero{};
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.levelCount = 1;
+    range.layerCount = 1;
+    vkCmdClearColorImage(cmd, vkVolumeDensityImage,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &zero, 1,
+                         &range);
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &barrier);
+
+    vkEndCommandBuffer(cmd);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    vkQueueSubmit(vkComputeQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    vkQueueWaitIdle(vkComputeQueue);
+    vkFreeCommandBuffers(vkDevice, vkCommandPool, 1, &cmd);
+  }
+
+  volumeDensityExtent_ = glm::ivec3(resX, resY, resZ);
+  return true;
+}
+
 bool VulkanRenderer::createDescriptorSets() {
   // Create descriptor set layout
-  std::array<VkDescriptorSetLayoutBinding, 7> bindings{};
+  std::array<VkDescriptorSetLayoutBinding, 13> bindings{};
 
   // Output image binding
   bindings[0].binding = 0;
@@ -462,12 +967,48 @@ bool VulkanRenderer::createDescriptorSets() {
   bindings[5].descriptorCount = 1;
   bindings[5].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
-  // Voxel data buffer binding
+  // Volume density 3D texture binding (trilinear-filtered)
   bindings[6].binding = 6;
-  bindings[6].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[6].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
   bindings[6].descriptorCount = 1;
   bindings[6].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
+  // BVH node buffer binding
+  bindings[7].binding = 7;
+  bindings[7].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[7].descriptorCount = 1;
+  bindings[7].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+  // BVH primitive index buffer binding
+  bindings[8].binding = 8;
+  bindings[8].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[8].descriptorCount = 1;
+  bindings[8].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+  // Volume brick occupancy grid binding
+  bindings[9].binding = 9;
+  bindings[9].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[9].descriptorCount = 1;
+  bindings[9].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+  // Accumulation image binding
+  bindings[10].binding = 10;
+  bindings[10].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+  bindings[10].descriptorCount = 1;
+  bindings[10].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+  // Low-discrepancy sample sequence binding
+  bindings[11].binding = 11;
+  bindings[11].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[11].descriptorCount = 1;
+  bindings[11].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+  // Triangle buffer binding
+  bindings[12].binding = 12;
+  bindings[12].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[12].descriptorCount = 1;
+  bindings[12].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
   VkDescriptorSetLayoutCreateInfo layoutInfo{};
   layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
   layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
@@ -478,19 +1019,26 @@ bool VulkanRenderer::createDescriptorSets() {
     return false;
   }
 
-  // Create descriptor pool
-  std::array<VkDescriptorPoolSize, 2> poolSizes{};
+  // Create descriptor pool. Budget covers the main set, up to 8
+  // per-swapchain-image sets for the direct-write present path (each
+  // carrying the full binding table), and the two-buffer animation
+  // pre-pass set.
+  const uint32_t maxSets = 1 + 8 + 1;
+  std::array<VkDescriptorPoolSize, 3> poolSizes{};
   poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-  poolSizes[0].descriptorCount = 1;
+  poolSizes[0].descriptorCount = 2 * maxSets; // output + accumulation
   poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
   poolSizes[1].descriptorCount =
-      6; // sphere, ellipsoid, material, light, volume, voxelData
+      10 * maxSets; // sphere, ellipsoid, material, light, volume, bvhNodes,
+                    // bvhIndices, occupancy, samples, triangles
+  poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  poolSizes[2].descriptorCount = maxSets; // volume density 3D texture
 
   VkDescriptorPoolCreateInfo poolInfo{};
   poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
   poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
   poolInfo.pPoolSizes = poolSizes.data();
-  poolInfo.maxSets = 1;
+  poolInfo.maxSets = maxSets;
 
   if (vkCreateDescriptorPool(vkDevice, &poolInfo, nullptr, &vkDescriptorPool) !=
       VK_SUCCESS) {
@@ -524,42 +1072,35 @@ bool VulkanRenderer::createComputePipeline() {
     return false;
   }
 
-  // Write modified shader to temp file
+  // Compile shader (served from the on-disk SPIR-V cache when the composed
+  // source is unchanged between runs)
   const std::string tempShaderPath = "shaders/raytrace.injected.comp";
-  std::ofstream tempFile(tempShaderPath);
-  if (!tempFile.is_open()) {
-    std::cerr << "Failed to write temporary shader file" << std::endl;
-    return false;
-  }
-  tempFile << modifiedShaderSource;
-  tempFile.close();
-
-  // Compile shader
   std::vector<uint32_t> shaderCode;
   try {
-    shaderCode = ShaderCompiler::compileShader(tempShaderPath,
-                                               VK_SHADER_STAGE_COMPUTE_BIT);
+    shaderCode = ShaderCompiler::compileShaderSourceCached(
+        modifiedShaderSource, tempShaderPath, "shaders/cache");
   } catch (const std::exception &e) {
     std::cerr << "Shader compilation failed: " << e.what() << std::endl;
     return false;
   }
 
-  VkShaderModuleCreateInfo moduleInfo{};
-  moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-  moduleInfo.codeSize = shaderCode.size() * sizeof(uint32_t);
-  moduleInfo.pCode = shaderCode.data();
-
-  VkShaderModule shaderModule;
-  if (vkCreateShaderModule(vkDevice, &moduleInfo, nullptr, &shaderModule) !=
-      VK_SUCCESS) {
-    return false;
+  // Pick the workgroup shape per vendor: 256-lane groups suit RDNA's
+  // wave32/wave64 scheduling, while NVIDIA cards do better with 128 lanes
+  // given this kernel's register pressure. Clamp to the device limit either
+  // way.
+  workgroupSizeX = 16;
+  workgroupSizeY = (deviceProperties.vendorID == 0x10DE) ? 8 : 16;
+  while (workgroupSizeX * workgroupSizeY >
+         deviceProperties.limits.maxComputeWorkGroupInvocations) {
+    if (workgroupSizeY >= workgroupSizeX) {
+      workgroupSizeY /= 2;
+    } else {
+      workgroupSizeX /= 2;
+    }
   }
 
-  VkPipelineShaderStageCreateInfo stageInfo{};
-  stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-  stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-  stageInfo.module = shaderModule;
-  stageInfo.pName = "main";
+  std::cout << "Compute workgroup " << workgroupSizeX << "x" << workgroupSizeY
+            << ", max bounce depth " << maxBounceDepth << std::endl;
 
   // Push constant range
   VkPushConstantRange pushConstantRange{};
@@ -579,43 +1120,346 @@ bool VulkanRenderer::createComputePipeline() {
     return false;
   }
 
-  VkComputePipelineCreateInfo pipelineInfo{};
-  pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-  pipelineInfo.layout = vkPipelineLayout;
-  pipelineInfo.stage = stageInfo;
+  // Seed the pipeline cache from disk so warm starts skip driver compilation
+  const std::string pipelineCachePath = "shaders/cache/pipeline.cache";
+  std::vector<char> pipelineCacheData;
+  {
+    std::ifstream cacheFile(pipelineCachePath, std::ios::ate | std::ios::binary);
+    if (cacheFile.is_open()) {
+      size_t cacheSize = static_cast<size_t>(cacheFile.tellg());
+      pipelineCacheData.resize(cacheSize);
+      cacheFile.seekg(0);
+      cacheFile.read(pipelineCacheData.data(), cacheSize);
+      std::cout << "Loaded pipeline cache (" << cacheSize << " bytes)"
+                << std::endl;
+    }
+  }
+
+  VkPipelineCacheCreateInfo cacheInfo{};
+  cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  cacheInfo.initialDataSize = pipelineCacheData.size();
+  cacheInfo.pInitialData =
+      pipelineCacheData.empty() ? nullptr : pipelineCacheData.data();
+
+  // Driver validates the cache header and ignores stale/foreign data
+  if (vkCreatePipelineCache(vkDevice, &cacheInfo, nullptr, &vkPipelineCache) !=
+      VK_SUCCESS) {
+    vkPipelineCache = VK_NULL_HANDLE;
+  }
 
-  if (vkCreateComputePipelines(vkDevice, VK_NULL_HANDLE, 1, &pipelineInfo,
-                               nullptr, &vkComputePipeline) != VK_SUCCESS) {
+  if (!buildComputePipelineFromCode(shaderCode, vkComputePipeline)) {
     return false;
   }
 
-  vkDestroyShaderModule(vkDevice, shaderModule, nullptr);
+  // Serialize the (possibly grown) pipeline cache back to disk
+  if (vkPipelineCache != VK_NULL_HANDLE) {
+    size_t cacheSize = 0;
+    vkGetPipelineCacheData(vkDevice, vkPipelineCache, &cacheSize, nullptr);
+    if (cacheSize > 0) {
+      std::vector<char> data(cacheSize);
+      vkGetPipelineCacheData(vkDevice, vkPipelineCache, &cacheSize,
+                             data.data());
+      std::ofstream cacheFile(pipelineCachePath, std::ios::binary);
+      if (cacheFile.is_open()) {
+        cacheFile.write(data.data(), static_cast<std::streamsize>(cacheSize));
+      }
+    }
+  }
 
   std::cout << "Compute pipeline created successfully" << std::endl;
   return true;
 }
 
-bool VulkanRenderer::createSwapChain(SDL_Window *window) {
-  // Create Vulkan surface from SDL window
-  if (window) {
-    if (!SDL_Vulkan_CreateSurface(window, vkInstance, nullptr, &vkSurface)) {
-      std::cerr << "Failed to create Vulkan surface: " << SDL_GetError()
-                << std::endl;
-      return false;
-    }
+bool VulkanRenderer::buildComputePipelineFromCode(
+    const std::vector<uint32_t> &shaderCode, VkPipeline &outPipeline) {
+  VkShaderModuleCreateInfo moduleInfo{};
+  moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  moduleInfo.codeSize = shaderCode.size() * sizeof(uint32_t);
+  moduleInfo.pCode = shaderCode.data();
+
+  VkShaderModule shaderModule;
+  if (vkCreateShaderModule(vkDevice, &moduleInfo, nullptr, &shaderModule) !=
+      VK_SUCCESS) {
+    return false;
   }
 
-  if (vkSurface != VK_NULL_HANDLE) {
-    // Query surface capabilities
-    VkSurfaceCapabilitiesKHR surfaceCapabilities;
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vkPhysicalDevice, vkSurface,
-                                              &surfaceCapabilities);
+  // Specialization constants: ids 0/1 are the workgroup shape, id 2 the
+  // bounce depth (compile-time bound so the driver can unroll the loop)
+  struct SpecializationData {
+    uint32_t workgroupSizeX;
+    uint32_t workgroupSizeY;
+    int32_t maxBounces;
+  } specializationData{workgroupSizeX, workgroupSizeY, maxBounceDepth};
+
+  VkSpecializationMapEntry specEntries[3]{};
+  specEntries[0].constantID = 0;
+  specEntries[0].offset = offsetof(SpecializationData, workgroupSizeX);
+  specEntries[0].size = sizeof(uint32_t);
+  specEntries[1].constantID = 1;
+  specEntries[1].offset = offsetof(SpecializationData, workgroupSizeY);
+  specEntries[1].size = sizeof(uint32_t);
+  specEntries[2].constantID = 2;
+  specEntries[2].offset = offsetof(SpecializationData, maxBounces);
+  specEntries[2].size = sizeof(int32_t);
+
+  VkSpecializationInfo specInfo{};
+  specInfo.mapEntryCount = 3;
+  specInfo.pMapEntries = specEntries;
+  specInfo.dataSize = sizeof(specializationData);
+  specInfo.pData = &specializationData;
 
-    // Query surface formats
-    uint32_t formatCount;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(vkPhysicalDevice, vkSurface,
-                                         &formatCount, nullptr);
-    std::vector<VkSurfaceFormatKHR> surfaceFormats(formatCount);
+  VkPipelineShaderStageCreateInfo stageInfo{};
+  stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  stageInfo.module = shaderModule;
+  stageInfo.pName = "main";
+  stageInfo.pSpecializationInfo = &specInfo;
+
+  VkComputePipelineCreateInfo pipelineInfo{};
+  pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  pipelineInfo.layout = vkPipelineLayout;
+  pipelineInfo.stage = stageInfo;
+
+  // The pipeline cache is internally synchronized, so the hot-reload thread
+  // can build here while the render loop keeps dispatching
+  VkResult result = vkCreateComputePipelines(vkDevice, vkPipelineCache, 1,
+                                             &pipelineInfo, nullptr,
+                                             &outPipeline);
+  vkDestroyShaderModule(vkDevice, shaderModule, nullptr);
+  return result == VK_SUCCESS;
+}
+
+bool VulkanRenderer::createAnimationPipeline() {
+  // The pre-pass sees only the ellipsoid buffer (read-write) and the
+  // animation records (read-only), so it gets its own two-binding layout
+  std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+  bindings[0].binding = 0;
+  bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[0].descriptorCount = 1;
+  bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  bindings[1] = bindings[0];
+  bindings[1].binding = 1;
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+
+  if (vkCreateDescriptorSetLayout(vkDevice, &layoutInfo, nullptr,
+                                  &vkAnimDescriptorSetLayout) != VK_SUCCESS) {
+    return false;
+  }
+
+  VkDescriptorSetAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocInfo.descriptorPool = vkDescriptorPool;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &vkAnimDescriptorSetLayout;
+
+  if (vkAllocateDescriptorSets(vkDevice, &allocInfo, &vkAnimDescriptorSet) !=
+      VK_SUCCESS) {
+    return false;
+  }
+
+  // Push constants: frame time + record count
+  VkPushConstantRange pushConstantRange{};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  pushConstantRange.size = sizeof(float) + sizeof(int32_t);
+  pushConstantRange.offset = 0;
+
+  VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+  pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &vkAnimDescriptorSetLayout;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+  if (vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, nullptr,
+                             &vkAnimPipelineLayout) != VK_SUCCESS) {
+    return false;
+  }
+
+  std::vector<uint32_t> shaderCode;
+  try {
+    shaderCode = ShaderCompiler::compileShader("shaders/animate.comp",
+                                               VK_SHADER_STAGE_COMPUTE_BIT);
+  } catch (const std::exception &e) {
+    std::cerr << "Animation shader compilation failed: " << e.what()
+              << std::endl;
+    return false;
+  }
+
+  VkShaderModuleCreateInfo moduleInfo{};
+  moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  moduleInfo.codeSize = shaderCode.size() * sizeof(uint32_t);
+  moduleInfo.pCode = shaderCode.data();
+
+  VkShaderModule shaderModule;
+  if (vkCreateShaderModule(vkDevice, &moduleInfo, nullptr, &shaderModule) !=
+      VK_SUCCESS) {
+    return false;
+  }
+
+  VkPipelineShaderStageCreateInfo stageInfo{};
+  stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  stageInfo.module = shaderModule;
+  stageInfo.pName = "main";
+
+  VkComputePipelineCreateInfo pipelineInfo{};
+  pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  pipelineInfo.layout = vkAnimPipelineLayout;
+  pipelineInfo.stage = stageInfo;
+
+  VkResult result = vkCreateComputePipelines(vkDevice, vkPipelineCache, 1,
+                                             &pipelineInfo, nullptr,
+                                             &vkAnimPipeline);
+  vkDestroyShaderModule(vkDevice, shaderModule, nullptr);
+  if (result != VK_SUCCESS) {
+    return false;
+  }
+
+  std::cout << "Animation pipeline created successfully" << std::endl;
+  return true;
+}
+
+void VulkanRenderer::enableShaderHotReload() {
+  if (shaderWatchThread_.joinable()) {
+    return;
+  }
+  shaderWatchStop_.store(false);
+  shaderWatchThread_ = std::thread(&VulkanRenderer::shaderWatchLoop, this);
+  std::cout << "Shader hot reload enabled (watching shaders/surface_shaders)"
+            << std::endl;
+}
+
+void VulkanRenderer::shaderWatchLoop() {
+  namespace fs = std::filesystem;
+  const std::string mainShaderPath = "shaders/raytrace.comp";
+  const std::string surfaceShaderDir = "shaders/surface_shaders";
+
+  // Mtime snapshot of the main shader plus every surface .glsl; inotify
+  // would save the polls, but a half-second poll over a handful of files is
+  // portable and invisible next to glslc
+  auto snapshot = [&]() {
+    std::map<std::string, fs::file_time_type> times;
+    std::error_code ec;
+    auto mainTime = fs::last_write_time(mainShaderPath, ec);
+    if (!ec) {
+      times[mainShaderPath] = mainTime;
+    }
+    if (fs::exists(surfaceShaderDir, ec)) {
+      for (const auto &entry : fs::directory_iterator(surfaceShaderDir, ec)) {
+        if (entry.path().extension() == ".glsl") {
+          auto writeTime = fs::last_write_time(entry.path(), ec);
+          if (!ec) {
+            times[entry.path().string()] = writeTime;
+          }
+        }
+      }
+    }
+    return times;
+  };
+
+  auto lastSeen = snapshot();
+  while (!shaderWatchStop_.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    if (shaderWatchStop_.load()) {
+      break;
+    }
+
+    auto current = snapshot();
+    if (current == lastSeen) {
+      continue;
+    }
+    lastSeen = std::move(current);
+
+    // Let the render loop adopt the previous swap before building another
+    if (pendingComputePipeline_.load() != VK_NULL_HANDLE) {
+      continue;
+    }
+
+    std::cout << "Surface shader change detected, recompiling in background"
+              << std::endl;
+
+    std::unordered_map<std::string, int> newPathToIndex;
+    std::vector<uint32_t> shaderCode;
+    try {
+      std::string source = ShaderCompiler::loadAndInjectSurfaceShaders(
+          mainShaderPath, surfaceShaderDir, newPathToIndex);
+      shaderCode = ShaderCompiler::compileShaderSourceCached(
+          source, "shaders/raytrace.injected.comp", "shaders/cache");
+    } catch (const std::exception &e) {
+      std::cerr << "Hot reload compile failed, keeping current pipeline: "
+                << e.what() << std::endl;
+      continue;
+    }
+
+    // Editing file contents keeps the path->index mapping stable; adding or
+    // renaming shaders shifts it, and uploaded materials still carry the old
+    // indices until the next restart
+    if (newPathToIndex != shaderPathToIndex_) {
+      std::cerr << "Surface shader set changed; materials keep their old "
+                   "shader indices until restart"
+                << std::endl;
+    }
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (!buildComputePipelineFromCode(shaderCode, pipeline)) {
+      std::cerr << "Hot reload pipeline creation failed, keeping current "
+                   "pipeline"
+                << std::endl;
+      continue;
+    }
+    pendingComputePipeline_.store(pipeline);
+  }
+}
+
+void VulkanRenderer::swapPendingPipeline() {
+  // Destroy replaced pipelines once every frame slot has cycled past them
+  for (auto it = retiredPipelines_.begin(); it != retiredPipelines_.end();) {
+    if (--it->second <= 0) {
+      vkDestroyPipeline(vkDevice, it->first, nullptr);
+      it = retiredPipelines_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  VkPipeline pending = pendingComputePipeline_.exchange(VK_NULL_HANDLE);
+  if (pending == VK_NULL_HANDLE) {
+    return;
+  }
+
+  // In-flight command buffers may still reference the old pipeline; keep it
+  // alive until their slots have been fenced again
+  retiredPipelines_.emplace_back(vkComputePipeline, MAX_FRAMES_IN_FLIGHT);
+  vkComputePipeline = pending;
+  sceneDirty = true; // Restart accumulation under the new shading
+  std::cout << "Hot-swapped compute pipeline" << std::endl;
+}
+
+bool VulkanRenderer::createSwapChain(SDL_Window *window) {
+  // Create Vulkan surface from SDL window
+  if (window) {
+    if (!SDL_Vulkan_CreateSurface(window, vkInstance, nullptr, &vkSurface)) {
+      std::cerr << "Failed to create Vulkan surface: " << SDL_GetError()
+                << std::endl;
+      return false;
+    }
+  }
+
+  if (vkSurface != VK_NULL_HANDLE) {
+    // Query surface capabilities
+    VkSurfaceCapabilitiesKHR surfaceCapabilities;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vkPhysicalDevice, vkSurface,
+                                              &surfaceCapabilities);
+
+    // Query surface formats
+    uint32_t formatCount;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(vkPhysicalDevice, vkSurface,
+                                         &formatCount, nullptr);
+    std::vector<VkSurfaceFormatKHR> surfaceFormats(formatCount);
     vkGetPhysicalDeviceSurfaceFormatsKHR(vkPhysicalDevice, vkSurface,
                                          &formatCount, surfaceFormats.data());
 
@@ -629,6 +1473,20 @@ bool VulkanRenderer::createSwapChain(SDL_Window *window) {
       }
     }
 
+    // Direct-write present path: if the surface supports storage images and
+    // offers R8G8B8A8_UNORM (the one format SPIR-V's rgba8 layout can
+    // write), take it so the compute pass can target the swapchain image
+    // and skip the full-screen blit
+    if (surfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) {
+      for (const auto &format : surfaceFormats) {
+        if (format.format == VK_FORMAT_R8G8B8A8_UNORM) {
+          chosenFormat = format;
+          swapchainStorageWrite_ = true;
+          break;
+        }
+      }
+    }
+
     vkSwapchainImageFormat = chosenFormat.format;
     vkSwapchainExtent = surfaceCapabilities.currentExtent;
     if (vkSwapchainExtent.width == UINT32_MAX) {
@@ -669,7 +1527,8 @@ bool VulkanRenderer::createSwapChain(SDL_Window *window) {
     swapchainInfo.imageExtent = vkSwapchainExtent;
     swapchainInfo.imageArrayLayers = 1;
     swapchainInfo.imageUsage =
-        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+        (swapchainStorageWrite_ ? VK_IMAGE_USAGE_STORAGE_BIT : 0);
     swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
     swapchainInfo.preTransform = surfaceCapabilities.currentTransform;
     swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
@@ -709,6 +1568,39 @@ bool VulkanRenderer::createSwapChain(SDL_Window *window) {
       }
     }
 
+    // Per-image descriptor sets for the direct-write path (identical to the
+    // main set except binding 0 targets the swapchain image). Fall back to
+    // the blit if the extent doesn't match the dispatch size or the pool's
+    // set budget is exceeded.
+    if (swapchainStorageWrite_) {
+      if (vkSwapchainExtent.width != static_cast<uint32_t>(windowWidth) ||
+          vkSwapchainExtent.height != static_cast<uint32_t>(windowHeight) ||
+          imageCount > 8) {
+        swapchainStorageWrite_ = false;
+      } else {
+        std::vector<VkDescriptorSetLayout> layouts(imageCount,
+                                                   vkDescriptorSetLayout);
+        VkDescriptorSetAllocateInfo setAllocInfo{};
+        setAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        setAllocInfo.descriptorPool = vkDescriptorPool;
+        setAllocInfo.descriptorSetCount = imageCount;
+        setAllocInfo.pSetLayouts = layouts.data();
+
+        vkSwapchainDescriptorSets_.resize(imageCount);
+        if (vkAllocateDescriptorSets(vkDevice, &setAllocInfo,
+                                     vkSwapchainDescriptorSets_.data()) !=
+            VK_SUCCESS) {
+          vkSwapchainDescriptorSets_.clear();
+          swapchainStorageWrite_ = false;
+        }
+      }
+      if (swapchainStorageWrite_) {
+        std::cout << "Swapchain supports storage writes - compute targets it "
+                     "directly, blit pass skipped"
+                  << std::endl;
+      }
+    }
+
     // Create semaphores for synchronization (one per swapchain image)
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -787,6 +1679,37 @@ bool VulkanRenderer::createSwapChain(SDL_Window *window) {
     return false;
   }
 
+  // Accumulation image (rgba32f) for progressive refinement: the shader sums
+  // samples here and resolves the average into the rgba8 output image
+  imageInfo.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+  imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT;
+
+  if (vkCreateImage(vkDevice, &imageInfo, nullptr, &vkAccumImage) !=
+      VK_SUCCESS) {
+    return false;
+  }
+
+  vkGetImageMemoryRequirements(vkDevice, vkAccumImage, &memReqs);
+  allocInfo.allocationSize = memReqs.size;
+  allocInfo.memoryTypeIndex =
+      findMemoryType(memoryProperties, memReqs.memoryTypeBits,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+  if (vkAllocateMemory(vkDevice, &allocInfo, nullptr, &vkAccumImageMemory) !=
+          VK_SUCCESS ||
+      vkBindImageMemory(vkDevice, vkAccumImage, vkAccumImageMemory, 0) !=
+          VK_SUCCESS) {
+    return false;
+  }
+
+  viewInfo.image = vkAccumImage;
+  viewInfo.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+
+  if (vkCreateImageView(vkDevice, &viewInfo, nullptr, &vkAccumImageView) !=
+      VK_SUCCESS) {
+    return false;
+  }
+
   std::cout << "Compute output image created successfully" << std::endl;
   return true;
 }
@@ -796,7 +1719,26 @@ void VulkanRenderer::updateScene(const std::vector<GPUSphere> &spheres,
                                  const std::vector<GPUMaterial> &materials,
                                  const std::vector<GPULight> &lights,
                                  const std::vector<GPUVolumetricData> &volumes,
-                                 const std::vector<uint8_t> &voxelData) {
+                                 const std::vector<uint8_t> &voxelData,
+                                 const std::vector<GPUTriangle> &triangles) {
+  // Full update - callers with mostly-static scenes should use the
+  // per-category setters instead so unchanged buffers are never touched
+  updateSpheres(spheres);
+  updateEllipsoids(ellipsoids);
+  if (!triangles.empty()) {
+    updateTriangles(triangles);
+  }
+  updateMaterials(materials);
+  updateLights(lights);
+  updateVolumes(volumes);
+  updateVoxelData(voxelData);
+}
+
+void VulkanRenderer::updateSpheres(const std::vector<GPUSphere> &spheres) {
+  sceneDirty = true;
+  cachedSpheres_ = spheres;
+  rebuildBVH();
+
   // Convert sphere data to include materialIndex
   if (!spheres.empty()) {
     // Create a packed structure matching GLSL layout
@@ -823,57 +1765,193 @@ void VulkanRenderer::updateScene(const std::vector<GPUSphere> &spheres,
 
     VkDeviceSize size = sphereData.size() * sizeof(PackedSphere);
     if (useDeviceLocalBuffers) {
-      // Staging upload
-      VkBuffer stagingBuf;
-      VkDeviceMemory stagingMem;
-      if (!createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        stagingBuf, stagingMem))
+      if (!stageUpload(vkSphereBuffer, sphereData.data(), size))
         return;
-      void *data;
-      vkMapMemory(vkDevice, stagingMem, 0, size, 0, &data);
-      std::memcpy(data, sphereData.data(), size);
-      vkUnmapMemory(vkDevice, stagingMem);
-      copyBuffer(stagingBuf, vkSphereBuffer, size);
-      vkDestroyBuffer(vkDevice, stagingBuf, nullptr);
-      vkFreeMemory(vkDevice, stagingMem, nullptr);
     } else {
-      void *data;
-      vkMapMemory(vkDevice, vkSphereBufferMemory, 0, size, 0, &data);
-      std::memcpy(data, sphereData.data(), size);
-      vkUnmapMemory(vkDevice, vkSphereBufferMemory);
+      std::memcpy(arenaMappedPtr(vkSphereBuffer), sphereData.data(), size);
     }
   }
+}
+
+void VulkanRenderer::updateEllipsoids(
+    const std::vector<GPUEllipsoid> &ellipsoids) {
+  sceneDirty = true;
+  cachedEllipsoids_ = ellipsoids;
+  rebuildBVH();
 
   // Copy ellipsoid data
   if (!ellipsoids.empty()) {
     VkDeviceSize size = ellipsoids.size() * sizeof(GPUEllipsoid);
     if (useDeviceLocalBuffers) {
-      VkBuffer stagingBuf;
-      VkDeviceMemory stagingMem;
-      if (!createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        stagingBuf, stagingMem))
+      if (!stageUpload(vkEllipsoidBuffer, ellipsoids.data(), size))
+        return;
+    } else {
+      std::memcpy(arenaMappedPtr(vkEllipsoidBuffer), ellipsoids.data(), size);
+    }
+  }
+}
+
+void VulkanRenderer::updateTriangles(
+    const std::vector<GPUTriangle> &triangles) {
+  sceneDirty = true;
+  cachedTriangles_ = triangles;
+
+  if (!triangles.empty()) {
+    // Grow the buffer when a mesh outruns the capacity. Recreation drains
+    // the queue (no in-flight frame may still read the old buffer) and
+    // rewrites every descriptor set, so this is a load-time path.
+    if (triangles.size() > triangleBufferCapacity_) {
+      vkDeviceWaitIdle(vkDevice);
+      destroyArenaBuffer(vkTriangleBuffer, vkTriangleBufferMemory);
+      while (triangleBufferCapacity_ < triangles.size()) {
+        triangleBufferCapacity_ *= 2;
+      }
+      VkBufferUsageFlags storageUsage =
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+          (useDeviceLocalBuffers ? VK_BUFFER_USAGE_TRANSFER_DST_BIT : 0);
+      if (!createBuffer(triangleBufferCapacity_ * sizeof(GPUTriangle),
+                        storageUsage,
+                        useDeviceLocalBuffers
+                            ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                            : (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+                        vkTriangleBuffer, vkTriangleBufferMemory)) {
+        std::cerr << "Failed to grow triangle buffer" << std::endl;
+        cachedTriangles_.clear();
+        return;
+      }
+      refreshDescriptorSets();
+    }
+
+    VkDeviceSize size = triangles.size() * sizeof(GPUTriangle);
+    if (useDeviceLocalBuffers) {
+      if (!stageUpload(vkTriangleBuffer, triangles.data(), size))
         return;
-      void *data;
-      vkMapMemory(vkDevice, stagingMem, 0, size, 0, &data);
-      std::memcpy(data, ellipsoids.data(), size);
-      vkUnmapMemory(vkDevice, stagingMem);
-      copyBuffer(stagingBuf, vkEllipsoidBuffer, size);
-      vkDestroyBuffer(vkDevice, stagingBuf, nullptr);
-      vkFreeMemory(vkDevice, stagingMem, nullptr);
     } else {
-      void *data;
-      vkMapMemory(vkDevice, vkEllipsoidBufferMemory, 0, size, 0, &data);
-      std::memcpy(data, ellipsoids.data(), size);
-      vkUnmapMemory(vkDevice, vkEllipsoidBufferMemory);
+      std::memcpy(arenaMappedPtr(vkTriangleBuffer), triangles.data(), size);
+    }
+  }
+
+  rebuildBVH();
+}
+
+void VulkanRenderer::setEllipsoidAnimations(
+    const std::vector<GPUAnimation> &animations) {
+  animationCount_ = static_cast<int>(animations.size());
+  if (animationCount_ == 0) {
+    // Back to CPU-side updates; restore tight BVH bounds
+    rebuildBVH();
+    sceneDirty = true;
+    return;
+  }
+
+  if (vkAnimPipeline == VK_NULL_HANDLE && !createAnimationPipeline()) {
+    std::cerr << "Animation pipeline unavailable, keeping CPU-side updates"
+              << std::endl;
+    animationCount_ = 0;
+    return;
+  }
+
+  // (Re)create the record buffer at the exact count; the arena recycles the
+  // old range
+  destroyArenaBuffer(vkAnimationBuffer, vkAnimationBufferMemory);
+  VkDeviceSize size = animations.size() * sizeof(GPUAnimation);
+  VkBufferUsageFlags storageUsage =
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+      (useDeviceLocalBuffers ? VK_BUFFER_USAGE_TRANSFER_DST_BIT : 0);
+  if (!createBuffer(size, storageUsage,
+                    useDeviceLocalBuffers
+                        ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                        : (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                           VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+                    vkAnimationBuffer, vkAnimationBufferMemory)) {
+    animationCount_ = 0;
+    return;
+  }
+
+  // Records change once per registration, so a blocking upload is fine
+  if (useDeviceLocalBuffers) {
+    stageUpload(vkAnimationBuffer, animations.data(), size);
+    flushSceneUpload(true);
+  } else {
+    std::memcpy(arenaMappedPtr(vkAnimationBuffer), animations.data(), size);
+  }
+
+  VkDescriptorBufferInfo ellipsoidInfo{};
+  ellipsoidInfo.buffer = vkEllipsoidBuffer;
+  ellipsoidInfo.range = VK_WHOLE_SIZE;
+  VkDescriptorBufferInfo animationInfo{};
+  animationInfo.buffer = vkAnimationBuffer;
+  animationInfo.range = VK_WHOLE_SIZE;
+
+  std::array<VkWriteDescriptorSet, 2> writes{};
+  writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writes[0].dstSet = vkAnimDescriptorSet;
+  writes[0].dstBinding = 0;
+  writes[0].descriptorCount = 1;
+  writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  writes[0].pBufferInfo = &ellipsoidInfo;
+  writes[1] = writes[0];
+  writes[1].dstBinding = 1;
+  writes[1].pBufferInfo = &animationInfo;
+  vkUpdateDescriptorSets(vkDevice, static_cast<uint32_t>(writes.size()),
+                         writes.data(), 0, nullptr);
+
+  // The GPU rotates ellipsoids after the CPU-built hierarchy is frozen, so
+  // rebuild it once with rotation-invariant bounds (see rebuildBVH)
+  rebuildBVH();
+  sceneDirty = true;
+  std::cout << "GPU animation enabled for " << animationCount_ << " ellipsoids"
+            << std::endl;
+}
+
+void VulkanRenderer::rebuildBVH() {
+  // Rebuild the BVH over spheres + ellipsoids and upload nodes + primitive
+  // indices. Median-split build is cheap enough to run on every scene update,
+  // which keeps the hierarchy valid for animated ellipsoids.
+  bvhNodeCount = 0;
+  if (!cachedSpheres_.empty() || !cachedEllipsoids_.empty() ||
+      !cachedTriangles_.empty()) {
+    std::vector<GPUEllipsoid> ellipsoids = cachedEllipsoids_;
+    if (animationCount_ > 0) {
+      // GPU-animated ellipsoids rotate after the hierarchy is built: bound
+      // each one by its rotation-invariant enclosing sphere (identity
+      // rotation, radii maxed) so the leaves stay valid at every angle
+      for (auto &ellipsoid : ellipsoids) {
+        float maxRadius = std::max(ellipsoid.radii.x,
+                                   std::max(ellipsoid.radii.y,
+                                            ellipsoid.radii.z));
+        ellipsoid.radii = glm::vec3(maxRadius);
+        ellipsoid.rotation = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+      }
+    }
+    BVH bvh;
+    bvh.build(cachedSpheres_, ellipsoids, cachedTriangles_);
+    bvhNodeCount = static_cast<int>(bvh.getNodes().size());
+
+    if (bvhNodeCount > 0) {
+      VkDeviceSize nodeSize = bvh.getNodes().size() * sizeof(GPUBVHNode);
+      VkDeviceSize indexSize =
+          bvh.getPrimitiveIndices().size() * sizeof(uint32_t);
+      if (useDeviceLocalBuffers) {
+        if (!stageUpload(vkBVHNodeBuffer, bvh.getNodes().data(), nodeSize) ||
+            !stageUpload(vkBVHIndexBuffer, bvh.getPrimitiveIndices().data(),
+                         indexSize))
+          return;
+      } else {
+        std::memcpy(arenaMappedPtr(vkBVHNodeBuffer), bvh.getNodes().data(),
+                    nodeSize);
+        std::memcpy(arenaMappedPtr(vkBVHIndexBuffer),
+                    bvh.getPrimitiveIndices().data(), indexSize);
+      }
     }
   }
+}
 
+void VulkanRenderer::updateLights(const std::vector<GPULight> &lights) {
   // Convert light data to vec4 format (position.xyz, intensity.w)
   if (!lights.empty()) {
+    sceneDirty = true;
     std::vector<glm::vec4> lightData(lights.size());
 
     // Parallel conversion of light data
@@ -884,117 +1962,497 @@ void VulkanRenderer::updateScene(const std::vector<GPUSphere> &spheres,
 
     VkDeviceSize size = lightData.size() * sizeof(glm::vec4);
     if (useDeviceLocalBuffers) {
-      VkBuffer stagingBuf;
-      VkDeviceMemory stagingMem;
-      if (!createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        stagingBuf, stagingMem))
+      if (!stageUpload(vkLightBuffer, lightData.data(), size))
         return;
-      void *data;
-      vkMapMemory(vkDevice, stagingMem, 0, size, 0, &data);
-      std::memcpy(data, lightData.data(), size);
-      vkUnmapMemory(vkDevice, stagingMem);
-      copyBuffer(stagingBuf, vkLightBuffer, size);
-      vkDestroyBuffer(vkDevice, stagingBuf, nullptr);
-      vkFreeMemory(vkDevice, stagingMem, nullptr);
     } else {
-      void *data;
-      vkMapMemory(vkDevice, vkLightBufferMemory, 0, size, 0, &data);
-      std::memcpy(data, lightData.data(), size);
-      vkUnmapMemory(vkDevice, vkLightBufferMemory);
+      std::memcpy(arenaMappedPtr(vkLightBuffer), lightData.data(), size);
     }
   }
+}
 
-  // Copy material data
+void VulkanRenderer::updateMaterials(const std::vector<GPUMaterial> &materials) {
   if (!materials.empty()) {
+    sceneDirty = true;
     VkDeviceSize size = materials.size() * sizeof(GPUMaterial);
     if (useDeviceLocalBuffers) {
-      VkBuffer stagingBuf;
-      VkDeviceMemory stagingMem;
-      if (!createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        stagingBuf, stagingMem))
+      if (!stageUpload(vkMaterialBuffer, materials.data(), size))
         return;
-      void *data;
-      vkMapMemory(vkDevice, stagingMem, 0, size, 0, &data);
-      std::memcpy(data, materials.data(), size);
-      vkUnmapMemory(vkDevice, stagingMem);
-      copyBuffer(stagingBuf, vkMaterialBuffer, size);
-      vkDestroyBuffer(vkDevice, stagingBuf, nullptr);
-      vkFreeMemory(vkDevice, stagingMem, nullptr);
     } else {
-      void *data;
-      vkMapMemory(vkDevice, vkMaterialBufferMemory, 0, size, 0, &data);
-      std::memcpy(data, materials.data(), size);
-      vkUnmapMemory(vkDevice, vkMaterialBufferMemory);
+      std::memcpy(arenaMappedPtr(vkMaterialBuffer), materials.data(), size);
+    }
+  }
+}
+
+bool VulkanRenderer::ensureVolumeDensityAtlas() {
+  // Pack every volume's slab along z with a one-slice gap between slabs so
+  // trilinear taps at a slab edge blend into zero instead of a neighbour
+  int atlasX = 1;
+  int atlasY = 1;
+  int atlasZ = 0;
+  volumeAtlasZOffset_.resize(cachedVolumes_.size());
+  for (size_t i = 0; i < cachedVolumes_.size(); i++) {
+    const GPUVolumetricData &vol = cachedVolumes_[i];
+    atlasX = std::max(atlasX, vol.resolution_x);
+    atlasY = std::max(atlasY, vol.resolution_y);
+    volumeAtlasZOffset_[i] = atlasZ;
+    atlasZ += vol.resolution_z + 1;
+  }
+  atlasZ = std::max(atlasZ - 1, 1); // No gap after the last slab
+
+  glm::ivec3 extent(atlasX, atlasY, atlasZ);
+  if (extent != volumeDensityExtent_) {
+    if (!createVolumeDensityImageResource(atlasX, atlasY, atlasZ)) {
+      return false;
     }
+    refreshDescriptorSets();
+    // Every slab starts empty in the new image
+    volumeUploaded_.assign(cachedVolumes_.size(), false);
+    std::cout << "Volume density atlas: " << atlasX << "x" << atlasY << "x"
+              << atlasZ << " for " << cachedVolumes_.size() << " volume(s)"
+              << std::endl;
+  } else {
+    volumeUploaded_.resize(cachedVolumes_.size(), false);
+  }
+
+  for (size_t i = 0; i < cachedVolumes_.size(); i++) {
+    GPUVolumetricData &vol = cachedVolumes_[i];
+    vol.atlasScale =
+        glm::vec3(static_cast<float>(vol.resolution_x) / atlasX,
+                  static_cast<float>(vol.resolution_y) / atlasY,
+                  static_cast<float>(vol.resolution_z) / atlasZ);
+    vol.atlasOffsetZ = static_cast<float>(volumeAtlasZOffset_[i]) / atlasZ;
   }
+  return true;
+}
 
-  // Copy volume data
+void VulkanRenderer::updateVolumes(
+    const std::vector<GPUVolumetricData> &volumes) {
   if (!volumes.empty()) {
-    VkDeviceSize size = volumes.size() * sizeof(GPUVolumetricData);
+    sceneDirty = true;
+
+    // Recompute the atlas layout and patch each volume's placement fields
+    // before the instance list goes to the GPU
+    cachedVolumes_ = volumes;
+    if (!ensureVolumeDensityAtlas()) {
+      return;
+    }
+
+    VkDeviceSize size = cachedVolumes_.size() * sizeof(GPUVolumetricData);
     if (useDeviceLocalBuffers) {
-      VkBuffer stagingBuf;
-      VkDeviceMemory stagingMem;
-      if (!createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        stagingBuf, stagingMem))
+      if (!stageUpload(vkVolumeBuffer, cachedVolumes_.data(), size))
         return;
-      void *data;
-      vkMapMemory(vkDevice, stagingMem, 0, size, 0, &data);
-      std::memcpy(data, volumes.data(), size);
-      vkUnmapMemory(vkDevice, stagingMem);
-      copyBuffer(stagingBuf, vkVolumeBuffer, size);
-      vkDestroyBuffer(vkDevice, stagingBuf, nullptr);
-      vkFreeMemory(vkDevice, stagingMem, nullptr);
     } else {
-      void *data;
-      vkMapMemory(vkDevice, vkVolumeBufferMemory, 0, size, 0, &data);
-      std::memcpy(data, volumes.data(), size);
-      vkUnmapMemory(vkDevice, vkVolumeBufferMemory);
+      std::memcpy(arenaMappedPtr(vkVolumeBuffer), cachedVolumes_.data(), size);
+    }
+  }
+}
+
+// Bricks of 8^3 voxels: coarse enough that the grid stays tiny, fine enough
+// that empty regions of sparse CT volumes skip in large steps
+static constexpr int OCCUPANCY_BRICK_SIZE = 8;
+
+// Build the brick occupancy grid: 4 header uints (grid resolution xyz +
+// brick size) followed by one word per brick, 1 if any voxel in the brick
+// has nonzero density
+static std::vector<uint32_t>
+buildOccupancyGrid(const std::vector<uint8_t> &voxelData,
+                   const glm::ivec3 &res) {
+  const int B = OCCUPANCY_BRICK_SIZE;
+  glm::ivec3 gridRes((res.x + B - 1) / B, (res.y + B - 1) / B,
+                     (res.z + B - 1) / B);
+
+  std::vector<uint32_t> grid(4 + static_cast<size_t>(gridRes.x) * gridRes.y *
+                                     gridRes.z,
+                             0);
+  grid[0] = static_cast<uint32_t>(gridRes.x);
+  grid[1] = static_cast<uint32_t>(gridRes.y);
+  grid[2] = static_cast<uint32_t>(gridRes.z);
+  grid[3] = static_cast<uint32_t>(B);
+
+  for (int bz = 0; bz < gridRes.z; bz++) {
+    for (int by = 0; by < gridRes.y; by++) {
+      for (int bx = 0; bx < gridRes.x; bx++) {
+        bool occupied = false;
+        int zEnd = std::min((bz + 1) * B, res.z);
+        int yEnd = std::min((by + 1) * B, res.y);
+        int xEnd = std::min((bx + 1) * B, res.x);
+        for (int z = bz * B; z < zEnd && !occupied; z++) {
+          for (int y = by * B; y < yEnd && !occupied; y++) {
+            size_t rowBase = static_cast<size_t>(z) * res.x * res.y +
+                             static_cast<size_t>(y) * res.x;
+            for (int x = bx * B; x < xEnd; x++) {
+              if (voxelData[rowBase + x] > 0) {
+                occupied = true;
+                break;
+              }
+            }
+          }
+        }
+        if (occupied) {
+          grid[4 + static_cast<size_t>(bz) * gridRes.x * gridRes.y +
+               static_cast<size_t>(by) * gridRes.x + bx] = 1;
+        }
+      }
     }
   }
 
-  // Copy voxel data (only upload once - persistent in VRAM)
-  if (!voxelData.empty() && !voxelDataUploaded) {
-    VkDeviceSize size = voxelData.size();
+  return grid;
+}
+
+void VulkanRenderer::updateVolumeDensity(int volumeIndex,
+                                         const std::vector<uint8_t> &voxelData) {
+  // Upload one volume's density bytes into its atlas slab (only once -
+  // persistent in VRAM)
+  if (voxelData.empty() || volumeIndex < 0 ||
+      volumeIndex >= static_cast<int>(cachedVolumes_.size()) ||
+      volumeUploaded_[volumeIndex]) {
+    return;
+  }
+
+  const GPUVolumetricData &vol = cachedVolumes_[volumeIndex];
+  glm::ivec3 res(vol.resolution_x, vol.resolution_y, vol.resolution_z);
+  if (res.x <= 0 || res.y <= 0 || res.z <= 0 ||
+      static_cast<size_t>(res.x) * res.y * res.z != voxelData.size()) {
+    std::cerr << "Voxel data size does not match volume " << volumeIndex
+              << " resolution, skipping upload" << std::endl;
+    return;
+  }
+  sceneDirty = true;
+
+  // Voxel data is far larger than the ring regions, so use a one-shot
+  // staging buffer that the batched flush destroys afterwards
+  VkBuffer stagingBuf;
+  VkDeviceMemory stagingMem;
+  if (!createBuffer(voxelData.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                    stagingBuf, stagingMem)) {
+    return;
+  }
+
+  std::memcpy(arenaMappedPtr(stagingBuf), voxelData.data(), voxelData.size());
+
+  beginSceneUpload();
+
+  VkImageMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.image = vkVolumeDensityImage;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.layerCount = 1;
+
+  vkCmdPipelineBarrier(vkUploadCommandBuffers[currentFrame],
+                       VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                       nullptr, 1, &barrier);
+
+  VkBufferImageCopy copyRegion{};
+  copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  copyRegion.imageSubresource.layerCount = 1;
+  copyRegion.imageOffset = {0, 0, volumeAtlasZOffset_[volumeIndex]};
+  copyRegion.imageExtent = {static_cast<uint32_t>(res.x),
+                            static_cast<uint32_t>(res.y),
+                            static_cast<uint32_t>(res.z)};
+
+  vkCmdCopyBufferToImage(vkUploadCommandBuffers[currentFrame], stagingBuf,
+                         vkVolumeDensityImage,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = 0;
+
+  // Destination stage is BOTTOM_OF_PIPE because shader stages are invalid on
+  // a dedicated transfer queue; the blocking flush below drains the queue
+  // before any dispatch can sample the image
+  vkCmdPipelineBarrier(vkUploadCommandBuffers[currentFrame],
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0,
+                       nullptr, 1, &barrier);
+
+  pendingStagingBuffers.emplace_back(stagingBuf, stagingMem);
+  flushSceneUpload(true);
+
+  // Build and upload the brick occupancy grid so the march loop can skip
+  // empty space. The grid only covers volume 0 (typically the large CT
+  // dataset); other volumes march without it.
+  if (volumeIndex == 0) {
+    std::vector<uint32_t> occupancy = buildOccupancyGrid(voxelData, res);
+    VkDeviceSize occupancySize = occupancy.size() * sizeof(uint32_t);
     if (useDeviceLocalBuffers) {
-      VkBuffer stagingBuf;
-      VkDeviceMemory stagingMem;
-      if (!createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        stagingBuf, stagingMem))
+      if (!stageUpload(vkOccupancyBuffer, occupancy.data(), occupancySize))
         return;
-      void *data;
-      vkMapMemory(vkDevice, stagingMem, 0, size, 0, &data);
-      std::memcpy(data, voxelData.data(), size);
-      vkUnmapMemory(vkDevice, stagingMem);
-      copyBuffer(stagingBuf, vkVoxelDataBuffer, size);
-      vkDestroyBuffer(vkDevice, stagingBuf, nullptr);
-      vkFreeMemory(vkDevice, stagingMem, nullptr);
+      flushSceneUpload(true);
     } else {
-      void *data;
-      vkMapMemory(vkDevice, vkVoxelDataBufferMemory, 0, size, 0, &data);
-      std::memcpy(data, voxelData.data(), size);
-      vkUnmapMemory(vkDevice, vkVoxelDataBufferMemory);
+      std::memcpy(arenaMappedPtr(vkOccupancyBuffer), occupancy.data(),
+                  occupancySize);
+    }
+  }
+
+  volumeUploaded_[volumeIndex] = true;
+  std::cout << "Volume " << volumeIndex << " density uploaded (" << res.x
+            << "x" << res.y << "x" << res.z << ", " << voxelData.size()
+            << " bytes)" << std::endl;
+}
+
+void VulkanRenderer::updateVoxelData(const std::vector<uint8_t> &voxelData) {
+  updateVolumeDensity(0, voxelData);
+}
+
+// Occupancy grid for a bricked volume: scan 8^3 sub-blocks of each occupied
+// file brick; empty file bricks contribute nothing (their words stay 0)
+static std::vector<uint32_t> buildOccupancyGridBricked(const VolumeFile &volume,
+                                                       const glm::ivec3 &res) {
+  const int B = OCCUPANCY_BRICK_SIZE;
+  const int FB = VolumeFile::BRICK_SIZE;
+  const int SUB = FB / B; // occupancy cells per file-brick axis
+  glm::ivec3 gridRes((res.x + B - 1) / B, (res.y + B - 1) / B,
+                     (res.z + B - 1) / B);
+
+  std::vector<uint32_t> grid(4 + static_cast<size_t>(gridRes.x) * gridRes.y *
+                                     gridRes.z,
+                             0);
+  grid[0] = static_cast<uint32_t>(gridRes.x);
+  grid[1] = static_cast<uint32_t>(gridRes.y);
+  grid[2] = static_cast<uint32_t>(gridRes.z);
+  grid[3] = static_cast<uint32_t>(B);
+
+  glm::ivec3 bricks = volume.brickCount();
+  for (int bz = 0; bz < bricks.z; bz++) {
+    for (int by = 0; by < bricks.y; by++) {
+      for (int bx = 0; bx < bricks.x; bx++) {
+        if (!volume.brickOccupied(bx, by, bz)) {
+          continue;
+        }
+        const uint8_t *brick = volume.brickData(bx, by, bz);
+
+        for (int sz = 0; sz < SUB; sz++) {
+          for (int sy = 0; sy < SUB; sy++) {
+            for (int sx = 0; sx < SUB; sx++) {
+              bool occupied = false;
+              for (int z = sz * B; z < (sz + 1) * B && !occupied; z++) {
+                for (int y = sy * B; y < (sy + 1) * B && !occupied; y++) {
+                  const uint8_t *row =
+                      brick + (static_cast<size_t>(z) * FB + y) * FB + sx * B;
+                  for (int x = 0; x < B; x++) {
+                    if (row[x] > 0) {
+                      occupied = true;
+                      break;
+                    }
+                  }
+                }
+              }
+              if (!occupied) {
+                continue;
+              }
+              int gx = bx * SUB + sx;
+              int gy = by * SUB + sy;
+              int gz = bz * SUB + sz;
+              if (gx < gridRes.x && gy < gridRes.y && gz < gridRes.z) {
+                grid[4 + static_cast<size_t>(gz) * gridRes.x * gridRes.y +
+                     static_cast<size_t>(gy) * gridRes.x + gx] = 1;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return grid;
+}
+
+void VulkanRenderer::updateVoxelData(const VolumeFile &volume) {
+  // Bricked streaming upload into volume 0's atlas slab. The atlas (created
+  // and cleared by updateVolumes) already samples as zero everywhere, so
+  // only occupied bricks need copying.
+  if (!volume.isOpen() || cachedVolumes_.empty() || volumeUploaded_[0]) {
+    return;
+  }
+
+  glm::ivec3 res = volume.resolution();
+  if (res.x != cachedVolumes_[0].resolution_x ||
+      res.y != cachedVolumes_[0].resolution_y ||
+      res.z != cachedVolumes_[0].resolution_z) {
+    std::cerr << "Bricked volume resolution does not match volume 0, "
+                 "skipping upload"
+              << std::endl;
+    return;
+  }
+  sceneDirty = true;
+  const int zBase = volumeAtlasZOffset_[0];
+
+  // Move the atlas into the transfer-destination layout for the chunk copies
+  {
+    beginSceneUpload();
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = vkVolumeDensityImage;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(vkUploadCommandBuffers[currentFrame],
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+    flushSceneUpload(true);
+  }
+
+  // Stream occupied bricks through bounded staging chunks; each chunk is one
+  // batched copy submission, so host memory use stays at CHUNK_BRICKS *
+  // BRICK_BYTES no matter how large the volume is
+  constexpr size_t CHUNK_BRICKS = 256; // 8 MB per chunk
+  const int FB = VolumeFile::BRICK_SIZE;
+  glm::ivec3 bricks = volume.brickCount();
+
+  VkBuffer chunkBuf = VK_NULL_HANDLE;
+  VkDeviceMemory chunkMem = VK_NULL_HANDLE;
+  uint8_t *chunkMapped = nullptr;
+  std::vector<VkBufferImageCopy> chunkRegions;
+  size_t bricksUploaded = 0;
+
+  auto flushChunk = [&]() {
+    if (chunkRegions.empty()) {
+      return;
+    }
+    chunkMapped = nullptr;
+
+    beginSceneUpload();
+    vkCmdCopyBufferToImage(vkUploadCommandBuffers[currentFrame], chunkBuf,
+                           vkVolumeDensityImage,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(chunkRegions.size()),
+                           chunkRegions.data());
+    pendingStagingBuffers.emplace_back(chunkBuf, chunkMem);
+    flushSceneUpload(true);
+
+    chunkBuf = VK_NULL_HANDLE;
+    chunkMem = VK_NULL_HANDLE;
+    chunkRegions.clear();
+  };
+
+  for (int bz = 0; bz < bricks.z; bz++) {
+    for (int by = 0; by < bricks.y; by++) {
+      for (int bx = 0; bx < bricks.x; bx++) {
+        if (!volume.brickOccupied(bx, by, bz)) {
+          continue;
+        }
+
+        if (chunkBuf == VK_NULL_HANDLE) {
+          if (!createBuffer(CHUNK_BRICKS * VolumeFile::BRICK_BYTES,
+                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            chunkBuf, chunkMem)) {
+            return;
+          }
+          chunkMapped = static_cast<uint8_t *>(arenaMappedPtr(chunkBuf));
+        }
+
+        size_t slot = chunkRegions.size();
+        std::memcpy(chunkMapped + slot * VolumeFile::BRICK_BYTES,
+                    volume.brickData(bx, by, bz), VolumeFile::BRICK_BYTES);
+
+        // Bricks are stored as full 32^3 blocks; the copy extent clamps at
+        // the volume edge while the buffer strides stay brick-sized
+        VkBufferImageCopy region{};
+        region.bufferOffset = slot * VolumeFile::BRICK_BYTES;
+        region.bufferRowLength = FB;
+        region.bufferImageHeight = FB;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {bx * FB, by * FB, zBase + bz * FB};
+        region.imageExtent = {
+            static_cast<uint32_t>(std::min(FB, res.x - bx * FB)),
+            static_cast<uint32_t>(std::min(FB, res.y - by * FB)),
+            static_cast<uint32_t>(std::min(FB, res.z - bz * FB))};
+        chunkRegions.push_back(region);
+        bricksUploaded++;
+
+        if (chunkRegions.size() == CHUNK_BRICKS) {
+          flushChunk();
+        }
+      }
+    }
+  }
+  flushChunk();
+
+  // Final transition to the sampled layout (BOTTOM_OF_PIPE: shader stages
+  // are invalid on a dedicated transfer queue, and this path drains the
+  // queue anyway)
+  {
+    beginSceneUpload();
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = vkVolumeDensityImage;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(vkUploadCommandBuffers[currentFrame],
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &barrier);
+    flushSceneUpload(true);
+  }
+
+  // Occupancy grid straight from the brick scan, no flat copy needed
+  std::vector<uint32_t> occupancy = buildOccupancyGridBricked(volume, res);
+  VkDeviceSize occupancySize = occupancy.size() * sizeof(uint32_t);
+  if (useDeviceLocalBuffers) {
+    if (!stageUpload(vkOccupancyBuffer, occupancy.data(), occupancySize)) {
+      return;
     }
-    voxelDataUploaded = true;  // Mark as uploaded
-    std::cout << "Voxel data uploaded to VRAM (" << size << " bytes)" << std::endl;
+    flushSceneUpload(true);
+  } else {
+    std::memcpy(arenaMappedPtr(vkOccupancyBuffer), occupancy.data(),
+                occupancySize);
+  }
+
+  volumeUploaded_[0] = true;
+  std::cout << "Streamed " << bricksUploaded << " occupied bricks ("
+            << bricksUploaded * VolumeFile::BRICK_BYTES / (1024 * 1024)
+            << " MB) into the 3D density texture (" << res.x << "x" << res.y
+            << "x" << res.z << ")" << std::endl;
+}
+
+void VulkanRenderer::refreshDescriptorSets() {
+  // Bind the buffer handles and images to the descriptor sets. Buffers never
+  // change identity after createBuffers; this reruns only when the volume
+  // density image is recreated at a new resolution.
+  writeDescriptorSet(vkDescriptorSet, vkOutputImageView);
+  for (size_t i = 0; i < vkSwapchainDescriptorSets_.size(); i++) {
+    writeDescriptorSet(vkSwapchainDescriptorSets_[i],
+                       vkSwapchainImageViews[i]);
   }
+}
 
-  // Update descriptor set with new buffers
-  std::array<VkWriteDescriptorSet, 7> descriptorWrites{};
+void VulkanRenderer::writeDescriptorSet(VkDescriptorSet set,
+                                        VkImageView outputView) {
+  std::array<VkWriteDescriptorSet, 13> descriptorWrites{};
 
   VkDescriptorImageInfo imageInfo{};
-  imageInfo.imageView = vkOutputImageView;
+  imageInfo.imageView = outputView;
   imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
   descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  descriptorWrites[0].dstSet = vkDescriptorSet;
+  descriptorWrites[0].dstSet = set;
   descriptorWrites[0].dstBinding = 0;
   descriptorWrites[0].descriptorCount = 1;
   descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
@@ -1006,7 +2464,7 @@ void VulkanRenderer::updateScene(const std::vector<GPUSphere> &spheres,
   sphereBufferInfo.range = VK_WHOLE_SIZE;
 
   descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  descriptorWrites[1].dstSet = vkDescriptorSet;
+  descriptorWrites[1].dstSet = set;
   descriptorWrites[1].dstBinding = 1;
   descriptorWrites[1].descriptorCount = 1;
   descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -1018,7 +2476,7 @@ void VulkanRenderer::updateScene(const std::vector<GPUSphere> &spheres,
   ellipsoidBufferInfo.range = VK_WHOLE_SIZE;
 
   descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  descriptorWrites[2].dstSet = vkDescriptorSet;
+  descriptorWrites[2].dstSet = set;
   descriptorWrites[2].dstBinding = 2;
   descriptorWrites[2].descriptorCount = 1;
   descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -1030,7 +2488,7 @@ void VulkanRenderer::updateScene(const std::vector<GPUSphere> &spheres,
   materialBufferInfo.range = VK_WHOLE_SIZE;
 
   descriptorWrites[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  descriptorWrites[3].dstSet = vkDescriptorSet;
+  descriptorWrites[3].dstSet = set;
   descriptorWrites[3].dstBinding = 3;
   descriptorWrites[3].descriptorCount = 1;
   descriptorWrites[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -1042,7 +2500,7 @@ void VulkanRenderer::updateScene(const std::vector<GPUSphere> &spheres,
   lightBufferInfo.range = VK_WHOLE_SIZE;
 
   descriptorWrites[4].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  descriptorWrites[4].dstSet = vkDescriptorSet;
+  descriptorWrites[4].dstSet = set;
   descriptorWrites[4].dstBinding = 4;
   descriptorWrites[4].descriptorCount = 1;
   descriptorWrites[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -1054,36 +2512,346 @@ void VulkanRenderer::updateScene(const std::vector<GPUSphere> &spheres,
   volumeBufferInfo.range = VK_WHOLE_SIZE;
 
   descriptorWrites[5].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  descriptorWrites[5].dstSet = vkDescriptorSet;
+  descriptorWrites[5].dstSet = set;
   descriptorWrites[5].dstBinding = 5;
   descriptorWrites[5].descriptorCount = 1;
   descriptorWrites[5].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
   descriptorWrites[5].pBufferInfo = &volumeBufferInfo;
 
-  VkDescriptorBufferInfo voxelDataBufferInfo{};
-  voxelDataBufferInfo.buffer = vkVoxelDataBuffer;
-  voxelDataBufferInfo.offset = 0;
-  voxelDataBufferInfo.range = VK_WHOLE_SIZE;
+  VkDescriptorImageInfo densityImageInfo{};
+  densityImageInfo.sampler = vkVolumeDensitySampler;
+  densityImageInfo.imageView = vkVolumeDensityImageView;
+  densityImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
   descriptorWrites[6].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  descriptorWrites[6].dstSet = vkDescriptorSet;
+  descriptorWrites[6].dstSet = set;
   descriptorWrites[6].dstBinding = 6;
   descriptorWrites[6].descriptorCount = 1;
-  descriptorWrites[6].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-  descriptorWrites[6].pBufferInfo = &voxelDataBufferInfo;
+  descriptorWrites[6].descriptorType =
+      VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  descriptorWrites[6].pImageInfo = &densityImageInfo;
+
+  VkDescriptorBufferInfo bvhNodeBufferInfo{};
+  bvhNodeBufferInfo.buffer = vkBVHNodeBuffer;
+  bvhNodeBufferInfo.offset = 0;
+  bvhNodeBufferInfo.range = VK_WHOLE_SIZE;
+
+  descriptorWrites[7].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrites[7].dstSet = set;
+  descriptorWrites[7].dstBinding = 7;
+  descriptorWrites[7].descriptorCount = 1;
+  descriptorWrites[7].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  descriptorWrites[7].pBufferInfo = &bvhNodeBufferInfo;
+
+  VkDescriptorBufferInfo bvhIndexBufferInfo{};
+  bvhIndexBufferInfo.buffer = vkBVHIndexBuffer;
+  bvhIndexBufferInfo.offset = 0;
+  bvhIndexBufferInfo.range = VK_WHOLE_SIZE;
+
+  descriptorWrites[8].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrites[8].dstSet = set;
+  descriptorWrites[8].dstBinding = 8;
+  descriptorWrites[8].descriptorCount = 1;
+  descriptorWrites[8].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  descriptorWrites[8].pBufferInfo = &bvhIndexBufferInfo;
+
+  VkDescriptorBufferInfo occupancyBufferInfo{};
+  occupancyBufferInfo.buffer = vkOccupancyBuffer;
+  occupancyBufferInfo.offset = 0;
+  occupancyBufferInfo.range = VK_WHOLE_SIZE;
+
+  descriptorWrites[9].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrites[9].dstSet = set;
+  descriptorWrites[9].dstBinding = 9;
+  descriptorWrites[9].descriptorCount = 1;
+  descriptorWrites[9].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  descriptorWrites[9].pBufferInfo = &occupancyBufferInfo;
+
+  VkDescriptorImageInfo accumImageInfo{};
+  accumImageInfo.imageView = vkAccumImageView;
+  accumImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+  descriptorWrites[10].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrites[10].dstSet = set;
+  descriptorWrites[10].dstBinding = 10;
+  descriptorWrites[10].descriptorCount = 1;
+  descriptorWrites[10].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+  descriptorWrites[10].pImageInfo = &accumImageInfo;
+
+  VkDescriptorBufferInfo sampleBufferInfo{};
+  sampleBufferInfo.buffer = vkSampleBuffer;
+  sampleBufferInfo.offset = 0;
+  sampleBufferInfo.range = VK_WHOLE_SIZE;
+
+  descriptorWrites[11].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrites[11].dstSet = set;
+  descriptorWrites[11].dstBinding = 11;
+  descriptorWrites[11].descriptorCount = 1;
+  descriptorWrites[11].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  descriptorWrites[11].pBufferInfo = &sampleBufferInfo;
+
+  VkDescriptorBufferInfo triangleBufferInfo{};
+  triangleBufferInfo.buffer = vkTriangleBuffer;
+  triangleBufferInfo.offset = 0;
+  triangleBufferInfo.range = VK_WHOLE_SIZE;
+
+  descriptorWrites[12].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  descriptorWrites[12].dstSet = set;
+  descriptorWrites[12].dstBinding = 12;
+  descriptorWrites[12].descriptorCount = 1;
+  descriptorWrites[12].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  descriptorWrites[12].pBufferInfo = &triangleBufferInfo;
 
   vkUpdateDescriptorSets(vkDevice,
                          static_cast<uint32_t>(descriptorWrites.size()),
                          descriptorWrites.data(), 0, nullptr);
 }
 
+void VulkanRenderer::enableReadback() {
+  if (readbackEnabled) {
+    return;
+  }
+
+  VkDeviceSize size = static_cast<VkDeviceSize>(windowWidth) * windowHeight * 4;
+  for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    if (!createBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                      vkReadbackBuffers[i], vkReadbackBufferMemory[i])) {
+      std::cerr << "Failed to create readback buffer" << std::endl;
+      return;
+    }
+    readbackMapped[i] = arenaMappedPtr(vkReadbackBuffers[i]);
+    if (readbackMapped[i] == nullptr) {
+      std::cerr << "Failed to map readback buffer" << std::endl;
+      return;
+    }
+  }
+
+  readbackEnabled = true;
+  std::cout << "Readback enabled (" << MAX_FRAMES_IN_FLIGHT
+            << " alternating buffers)" << std::endl;
+}
+
+bool VulkanRenderer::fetchPreviousFrame(std::vector<uint8_t> &outPixels) {
+  // After render() has advanced currentFrame, the frame BEFORE the one just
+  // submitted lives in the slot about to be reused - waiting on its fence
+  // does not block the frame currently on the GPU
+  uint32_t slot = currentFrame;
+  if (!readbackEnabled || !readbackSlotValid[slot]) {
+    return false;
+  }
+
+  vkWaitForFences(vkDevice, 1, &vkInFlightFences[slot], VK_TRUE, UINT64_MAX);
+
+  size_t size = static_cast<size_t>(windowWidth) * windowHeight * 4;
+  outPixels.resize(size);
+  std::memcpy(outPixels.data(), readbackMapped[slot], size);
+  return true;
+}
+
+bool VulkanRenderer::fetchLastFrame(std::vector<uint8_t> &outPixels) {
+  uint32_t slot =
+      (currentFrame + MAX_FRAMES_IN_FLIGHT - 1) % MAX_FRAMES_IN_FLIGHT;
+  if (!readbackEnabled || !readbackSlotValid[slot]) {
+    return false;
+  }
+
+  vkWaitForFences(vkDevice, 1, &vkInFlightFences[slot], VK_TRUE, UINT64_MAX);
+
+  size_t size = static_cast<size_t>(windowWidth) * windowHeight * 4;
+  outPixels.resize(size);
+  std::memcpy(outPixels.data(), readbackMapped[slot], size);
+  return true;
+}
+
+void VulkanRenderer::collectGpuTimings(uint32_t frameSlot) {
+  if (!timestampsSupported) {
+    return;
+  }
+
+  for (int stage = 0; stage < TIMING_STAGE_COUNT; stage++) {
+    if (!timingQueryIssued[frameSlot][stage]) {
+      continue;
+    }
+
+    // Each query returns its value plus an availability word; skip pairs the
+    // GPU hasn't finished yet instead of waiting
+    uint64_t results[4] = {};
+    if (vkGetQueryPoolResults(vkDevice, vkTimestampQueryPool,
+                              timingQueryIndex(frameSlot, stage), 2,
+                              sizeof(results), results, 2 * sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT |
+                                  VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) !=
+            VK_SUCCESS ||
+        results[1] == 0 || results[3] == 0) {
+      continue;
+    }
+
+    timingQueryIssued[frameSlot][stage] = false;
+
+    double ms = static_cast<double>(results[2] - results[0]) *
+                static_cast<double>(timestampPeriodNs) * 1e-6;
+    timingLastMs[stage] = ms;
+    timingSamples[stage].push_back(ms);
+    if (timingSamples[stage].size() > TIMING_WINDOW) {
+      timingSamples[stage].pop_front();
+    }
+  }
+}
+
+static VulkanRenderer::GpuStageStats
+summarizeStage(const std::deque<double> &samples, double lastMs) {
+  VulkanRenderer::GpuStageStats stats;
+  stats.lastMs = lastMs;
+  stats.sampleCount = static_cast<int>(samples.size());
+  if (samples.empty()) {
+    return stats;
+  }
+
+  std::vector<double> sorted(samples.begin(), samples.end());
+  std::sort(sorted.begin(), sorted.end());
+
+  double sum = 0.0;
+  for (double sample : sorted) {
+    sum += sample;
+  }
+  stats.averageMs = sum / static_cast<double>(sorted.size());
+  stats.p50Ms = sorted[sorted.size() / 2];
+  stats.p95Ms = sorted[(sorted.size() * 95) / 100];
+  return stats;
+}
+
+VulkanRenderer::GpuTimings VulkanRenderer::getGpuTimings() const {
+  GpuTimings timings;
+  timings.upload = summarizeStage(timingSamples[TIMING_STAGE_UPLOAD],
+                                  timingLastMs[TIMING_STAGE_UPLOAD]);
+  timings.compute = summarizeStage(timingSamples[TIMING_STAGE_COMPUTE],
+                                   timingLastMs[TIMING_STAGE_COMPUTE]);
+  timings.blit = summarizeStage(timingSamples[TIMING_STAGE_BLIT],
+                                timingLastMs[TIMING_STAGE_BLIT]);
+  return timings;
+}
+
+void VulkanRenderer::enableDynamicResolution(double targetFrameMs) {
+  if (!timestampsSupported) {
+    std::cerr << "Dynamic resolution needs timestamp queries, leaving it off"
+              << std::endl;
+    return;
+  }
+  dynamicResolutionEnabled_ = true;
+  targetFrameMs_ = targetFrameMs;
+  std::cout << "Dynamic resolution enabled (target " << targetFrameMs
+            << " ms compute)" << std::endl;
+}
+
+void VulkanRenderer::adjustRenderResolution() {
+  if (!dynamicResolutionEnabled_) {
+    return;
+  }
+  if (resolutionCooldown_ > 0) {
+    resolutionCooldown_--;
+    return;
+  }
+
+  double computeMs = timingLastMs[TIMING_STAGE_COMPUTE];
+  if (computeMs <= 0.0) {
+    return; // No finished sample yet
+  }
+
+  // Step down fast when over budget, creep back up only with clear headroom
+  // so the scale doesn't oscillate around the target
+  float newScale = renderScale_;
+  if (computeMs > targetFrameMs_ * 1.15) {
+    newScale *= 0.9f;
+  } else if (computeMs < targetFrameMs_ * 0.70) {
+    newScale *= 1.1f;
+  }
+  newScale = std::min(1.0f, std::max(0.25f, newScale));
+
+  int newWidth = std::max(1, static_cast<int>(windowWidth * newScale));
+  int newHeight = std::max(1, static_cast<int>(windowHeight * newScale));
+  if (newWidth == renderWidth_ && newHeight == renderHeight_) {
+    renderScale_ = newScale;
+    return;
+  }
+
+  renderScale_ = newScale;
+  renderWidth_ = newWidth;
+  renderHeight_ = newHeight;
+  // The accumulated image was traced at the old resolution
+  sceneDirty = true;
+  // Timing samples for frames already in flight still reflect the old
+  // resolution; wait them out before judging the new one
+  resolutionCooldown_ = MAX_FRAMES_IN_FLIGHT * 2;
+}
+
 void VulkanRenderer::render(const PushConstants &pushConstants) {
+  // Adopt a hot-reloaded pipeline, if the watcher finished one
+  swapPendingPipeline();
+
+  // Nudge the internal resolution toward the target compute time. Runs
+  // before the dirty check so a scale change restarts accumulation in the
+  // same frame instead of blending two resolutions for one frame.
+  adjustRenderResolution();
+
+  // Submit any scene uploads recorded since the last frame in one batch
+  flushSceneUpload();
+
+  // Restart accumulation when the view or the scene changed; otherwise keep
+  // summing samples so stationary views converge. GPU-animated scenes move
+  // every frame (just as per-frame updateEllipsoids did), so they restart
+  // unconditionally.
+  if (sceneDirty || animationCount_ > 0 ||
+      pushConstants.cameraMatrix != lastCameraMatrix) {
+    accumulatedSamples = 0;
+    // Fresh Cranley-Patterson rotation per accumulation run so successive
+    // runs don't replay the identical sample walk
+    scrambleIndex++;
+    lastCameraMatrix = pushConstants.cameraMatrix;
+    sceneDirty = false;
+  }
+
   // Wait for the fence of the current frame (ensures this frame's resources are
   // free)
   vkWaitForFences(vkDevice, 1, &vkInFlightFences[currentFrame], VK_TRUE,
                   UINT64_MAX);
   vkResetFences(vkDevice, 1, &vkInFlightFences[currentFrame]);
 
+  // Pick up this slot's finished timings (no-op for pairs beginSceneUpload
+  // already collected) and emit the periodic readout
+  collectGpuTimings(currentFrame);
+  if (gpuTimingLogInterval > 0 &&
+      ++gpuTimingFrameCounter >= gpuTimingLogInterval) {
+    gpuTimingFrameCounter = 0;
+    GpuTimings timings = getGpuTimings();
+    char line[160];
+    snprintf(line, sizeof(line),
+             "GPU ms: upload avg %.3f p95 %.3f | compute avg %.3f p95 %.3f | "
+             "blit avg %.3f p95 %.3f",
+             timings.upload.averageMs, timings.upload.p95Ms,
+             timings.compute.averageMs, timings.compute.p95Ms,
+             timings.blit.averageMs, timings.blit.p95Ms);
+    std::cout << line << std::endl;
+  }
+
+  // Direct-write path: the compute pass targets the acquired swapchain image
+  // itself, so the acquire has to happen before recording. Skipped while
+  // dynamic resolution has the region scaled down - the blit is the upsampler.
+  directPresentPending_ = swapchainStorageWrite_ &&
+                          renderWidth_ == windowWidth &&
+                          renderHeight_ == windowHeight;
+  if (directPresentPending_) {
+    VkResult acquire = vkAcquireNextImageKHR(
+        vkDevice, vkSwapchain, UINT64_MAX,
+        vkImageAvailableSemaphores[currentFrame], VK_NULL_HANDLE,
+        &currentImageIndex);
+    if (acquire != VK_SUCCESS && acquire != VK_SUBOPTIMAL_KHR) {
+      std::cerr << "Failed to acquire swapchain image" << std::endl;
+      directPresentPending_ = false;
+    }
+  }
+
   // Record commands for current frame's command buffer
   recordComputeCommands(pushConstants);
 
@@ -1092,11 +2860,45 @@ void VulkanRenderer::render(const PushConstants &pushConstants) {
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = &vkCommandBuffers[currentFrame];
 
-  // Submit with fence to signal when this frame completes
-  vkQueueSubmit(vkComputeQueue, 1, &submitInfo, vkInFlightFences[currentFrame]);
+  // Order this frame's upload batch before its compute dispatch, and on the
+  // direct-write path also wait for the acquired image before writing it
+  VkSemaphore waitSemaphores[2];
+  VkPipelineStageFlags waitStages[2];
+  uint32_t waitCount = 0;
+  if (uploadWaitPending) {
+    waitSemaphores[waitCount] = vkUploadSemaphores[currentFrame];
+    waitStages[waitCount] = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    waitCount++;
+    uploadWaitPending = false;
+  }
+  if (directPresentPending_) {
+    waitSemaphores[waitCount] = vkImageAvailableSemaphores[currentFrame];
+    waitStages[waitCount] = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    waitCount++;
+  }
+  submitInfo.waitSemaphoreCount = waitCount;
+  submitInfo.pWaitSemaphores = waitSemaphores;
+  submitInfo.pWaitDstStageMask = waitStages;
 
-  // Advance to next frame
-  currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+  if (directPresentPending_) {
+    // No blit submit follows: signal present's semaphore and the frame fence
+    // from the compute submit itself
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &vkRenderFinishedSemaphores[currentFrame];
+    vkQueueSubmit(vkComputeQueue, 1, &submitInfo,
+                  vkInFlightFences[currentFrame]);
+  } else if (vkSwapchain != VK_NULL_HANDLE) {
+    // With a swapchain, the frame's fence is signaled by the blit submit in
+    // present() so the whole frame (compute + blit) retires together
+    vkQueueSubmit(vkComputeQueue, 1, &submitInfo, VK_NULL_HANDLE);
+  } else {
+    // Headless callers get the old behavior of fencing the compute submit
+    vkQueueSubmit(vkComputeQueue, 1, &submitInfo,
+                  vkInFlightFences[currentFrame]);
+    currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+  }
+
+  accumulatedSamples++;
 }
 
 void VulkanRenderer::recordComputeCommands(const PushConstants &pushConstants) {
@@ -1111,36 +2913,164 @@ void VulkanRenderer::recordComputeCommands(const PushConstants &pushConstants) {
 
   vkBeginCommandBuffer(cmdBuffer, &beginInfo);
 
-  // Transition image layout to GENERAL for compute access
-  VkImageMemoryBarrier barrier{};
-  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-  barrier.image = vkOutputImage;
-  barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-  barrier.srcAccessMask = 0;
-  barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  barrier.subresourceRange.levelCount = 1;
-  barrier.subresourceRange.layerCount = 1;
+  if (timestampsSupported) {
+    uint32_t query = timingQueryIndex(currentFrame, TIMING_STAGE_COMPUTE);
+    vkCmdResetQueryPool(cmdBuffer, vkTimestampQueryPool, query, 2);
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        vkTimestampQueryPool, query);
+  }
+
+  // Animation pre-pass: rewrite ellipsoid rotations in place from the frame
+  // time, then fence the writes against the trace dispatch's reads
+  if (animationCount_ > 0 && vkAnimPipeline != VK_NULL_HANDLE) {
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      vkAnimPipeline);
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            vkAnimPipelineLayout, 0, 1, &vkAnimDescriptorSet,
+                            0, nullptr);
+    struct AnimPushConstants {
+      float time;
+      int32_t count;
+    } animConstants{pushConstants.time, animationCount_};
+    vkCmdPushConstants(cmdBuffer, vkAnimPipelineLayout,
+                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(animConstants),
+                       &animConstants);
+    vkCmdDispatch(cmdBuffer,
+                  (static_cast<uint32_t>(animationCount_) + 63) / 64, 1, 1);
+
+    VkBufferMemoryBarrier animBarrier{};
+    animBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    animBarrier.buffer = vkEllipsoidBuffer;
+    animBarrier.size = VK_WHOLE_SIZE;
+    animBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    animBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    animBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    animBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+                         1, &animBarrier, 0, nullptr);
+  }
 
-  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+  // Direct-write frames trace straight into the acquired swapchain image
+  VkImage targetImage = directPresentPending_
+                            ? vkSwapchainImages[currentImageIndex]
+                            : vkOutputImage;
+
+  // Transition image layouts to GENERAL for compute access. The accumulation
+  // image keeps its contents between frames, so after the first use its old
+  // layout must be GENERAL rather than UNDEFINED (which would discard).
+  std::array<VkImageMemoryBarrier, 2> barriers{};
+  barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barriers[0].image = targetImage;
+  barriers[0].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  barriers[0].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+  barriers[0].srcAccessMask = 0;
+  barriers[0].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  barriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barriers[0].subresourceRange.levelCount = 1;
+  barriers[0].subresourceRange.layerCount = 1;
+
+  barriers[1] = barriers[0];
+  barriers[1].image = vkAccumImage;
+  barriers[1].oldLayout = accumImageInitialized ? VK_IMAGE_LAYOUT_GENERAL
+                                                : VK_IMAGE_LAYOUT_UNDEFINED;
+  barriers[1].srcAccessMask =
+      accumImageInitialized ? VK_ACCESS_SHADER_WRITE_BIT : 0;
+  barriers[1].dstAccessMask =
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  accumImageInitialized = true;
+
+  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0,
-                       nullptr, 1, &barrier);
+                       nullptr, static_cast<uint32_t>(barriers.size()),
+                       barriers.data());
 
   vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
                     vkComputePipeline);
+  VkDescriptorSet frameSet =
+      directPresentPending_ ? vkSwapchainDescriptorSets_[currentImageIndex]
+                            : vkDescriptorSet;
   vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                          vkPipelineLayout, 0, 1, &vkDescriptorSet, 0, nullptr);
-
-  // Push constants to shader
+                          vkPipelineLayout, 0, 1, &frameSet, 0, nullptr);
+
+  // Push constants to shader (renderer fills in the BVH node count and the
+  // accumulation sample count so callers don't need to track either)
+  PushConstants constants = pushConstants;
+  constants.numBVHNodes = bvhNodeCount;
+  constants.sampleCount = accumulatedSamples;
+  constants.scrambleIndex = scrambleIndex;
+  constants.renderWidth = static_cast<float>(renderWidth_);
+  constants.renderHeight = static_cast<float>(renderHeight_);
+  constants.numTriangles = static_cast<int>(cachedTriangles_.size());
   vkCmdPushConstants(cmdBuffer, vkPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
-                     0, sizeof(PushConstants), &pushConstants);
-
-  // Dispatch compute shader with 16x16 workgroups (matches shader local size)
-  uint32_t groupCountX = (windowWidth + 15) / 16;
-  uint32_t groupCountY = (windowHeight + 15) / 16;
+                     0, sizeof(PushConstants), &constants);
+
+  // Dispatch over the (possibly downscaled) render region with the workgroup
+  // shape the pipeline was specialized to
+  uint32_t groupCountX =
+      (renderWidth_ + workgroupSizeX - 1) / workgroupSizeX;
+  uint32_t groupCountY =
+      (renderHeight_ + workgroupSizeY - 1) / workgroupSizeY;
   vkCmdDispatch(cmdBuffer, groupCountX, groupCountY, 1);
 
+  if (timestampsSupported) {
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        vkTimestampQueryPool,
+                        timingQueryIndex(currentFrame, TIMING_STAGE_COMPUTE) +
+                            1);
+    timingQueryIssued[currentFrame][TIMING_STAGE_COMPUTE] = true;
+  }
+
+  // Direct-write path: hand the traced swapchain image straight to present
+  if (directPresentPending_) {
+    VkImageMemoryBarrier presentBarrier{};
+    presentBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    presentBarrier.image = targetImage;
+    presentBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    presentBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    presentBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    presentBarrier.dstAccessMask = 0;
+    presentBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    presentBarrier.subresourceRange.levelCount = 1;
+    presentBarrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &presentBarrier);
+  }
+
+  // Headless batch mode: copy the finished frame into this slot's readback
+  // buffer inside the same command buffer, so the frame fence also covers
+  // the readback
+  if (readbackEnabled) {
+    VkImageMemoryBarrier readbackBarrier{};
+    readbackBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    readbackBarrier.image = vkOutputImage;
+    readbackBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    readbackBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    readbackBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    readbackBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    readbackBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    readbackBarrier.subresourceRange.levelCount = 1;
+    readbackBarrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &readbackBarrier);
+
+    VkBufferImageCopy copyRegion{};
+    copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copyRegion.imageSubresource.layerCount = 1;
+    copyRegion.imageExtent = {static_cast<uint32_t>(windowWidth),
+                              static_cast<uint32_t>(windowHeight), 1};
+
+    vkCmdCopyImageToBuffer(cmdBuffer, vkOutputImage,
+                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           vkReadbackBuffers[currentFrame], 1, &copyRegion);
+
+    readbackSlotValid[currentFrame] = true;
+  }
+
   vkEndCommandBuffer(cmdBuffer);
 }
 
@@ -1153,6 +3083,16 @@ bool VulkanRenderer::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
   bufferInfo.usage = usage;
   bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+  // Buffers are written on the transfer queue and read on the compute queue;
+  // CONCURRENT sharing avoids per-upload ownership-transfer barriers
+  uint32_t shareFamilies[2] = {computeQueueFamilyIndex,
+                               transferQueueFamilyIndex};
+  if (transferQueueFamilyIndex != computeQueueFamilyIndex) {
+    bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    bufferInfo.queueFamilyIndexCount = 2;
+    bufferInfo.pQueueFamilyIndices = shareFamilies;
+  }
+
   if (vkCreateBuffer(vkDevice, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
     return false;
   }
@@ -1160,70 +3100,233 @@ bool VulkanRenderer::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
   VkMemoryRequirements memReqs;
   vkGetBufferMemoryRequirements(vkDevice, buffer, &memReqs);
 
-  VkMemoryAllocateInfo allocInfo{};
-  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocInfo.allocationSize = memReqs.size;
-  allocInfo.memoryTypeIndex =
-      findMemoryType(memoryProperties, memReqs.memoryTypeBits, properties);
+  ArenaAllocation alloc;
+  if (!arenaAllocate(memReqs, properties, alloc)) {
+    vkDestroyBuffer(vkDevice, buffer, nullptr);
+    buffer = VK_NULL_HANDLE;
+    return false;
+  }
 
-  if (vkAllocateMemory(vkDevice, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+  ArenaBlock &block = arenaBlocks_[alloc.blockIndex];
+  if (vkBindBufferMemory(vkDevice, buffer, block.memory, alloc.offset) !=
+      VK_SUCCESS) {
+    arenaFree(alloc);
     vkDestroyBuffer(vkDevice, buffer, nullptr);
     buffer = VK_NULL_HANDLE;
     return false;
   }
 
-  vkBindBufferMemory(vkDevice, buffer, memory, 0);
+  arenaAllocations_[buffer] = alloc;
+  // Non-owning alias of the block's memory so existing callers keep working;
+  // destroyArenaBuffer nulls it without freeing
+  memory = block.memory;
   return true;
 }
 
-bool VulkanRenderer::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer,
-                                VkDeviceSize size) {
-  VkCommandBufferAllocateInfo allocInfo{};
-  allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  allocInfo.commandPool = vkCommandPool;
-  allocInfo.commandBufferCount = 1;
+bool VulkanRenderer::arenaAllocate(const VkMemoryRequirements &memReqs,
+                                   VkMemoryPropertyFlags properties,
+                                   ArenaAllocation &out) {
+  uint32_t typeIndex =
+      findMemoryType(memoryProperties, memReqs.memoryTypeBits, properties);
 
-  VkCommandBuffer cmd;
-  if (vkAllocateCommandBuffers(vkDevice, &allocInfo, &cmd) != VK_SUCCESS) {
-    return false;
+  // First fit over the matching blocks' free lists, honoring alignment.
+  // Free lists are small (a handful of buffers per block), so linear scan
+  // is fine.
+  for (size_t b = 0; b < arenaBlocks_.size(); ++b) {
+    ArenaBlock &block = arenaBlocks_[b];
+    if (block.memoryTypeIndex != typeIndex) {
+      continue;
+    }
+    for (size_t r = 0; r < block.freeRanges.size(); ++r) {
+      VkDeviceSize rangeOffset = block.freeRanges[r].first;
+      VkDeviceSize rangeSize = block.freeRanges[r].second;
+      VkDeviceSize aligned =
+          (rangeOffset + memReqs.alignment - 1) & ~(memReqs.alignment - 1);
+      VkDeviceSize padding = aligned - rangeOffset;
+      if (padding + memReqs.size > rangeSize) {
+        continue;
+      }
+
+      // Split the range: alignment padding stays free in front, the tail
+      // (if any) stays free behind
+      VkDeviceSize tail = rangeSize - padding - memReqs.size;
+      if (padding > 0 && tail > 0) {
+        block.freeRanges[r].second = padding;
+        block.freeRanges.insert(block.freeRanges.begin() + r + 1,
+                                {aligned + memReqs.size, tail});
+      } else if (padding > 0) {
+        block.freeRanges[r].second = padding;
+      } else if (tail > 0) {
+        block.freeRanges[r] = {aligned + memReqs.size, tail};
+      } else {
+        block.freeRanges.erase(block.freeRanges.begin() + r);
+      }
+
+      out.blockIndex = static_cast<int>(b);
+      out.offset = aligned;
+      out.size = memReqs.size;
+      return true;
+    }
   }
 
-  VkCommandBufferBeginInfo beginInfo{};
-  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-  vkBeginCommandBuffer(cmd, &beginInfo);
+  // No room - carve a new block, growing geometrically so a scene that keeps
+  // resizing settles into a few large allocations
+  VkDeviceSize blockSize = ARENA_MIN_BLOCK_SIZE;
+  for (const ArenaBlock &block : arenaBlocks_) {
+    if (block.memoryTypeIndex == typeIndex && block.size * 2 > blockSize) {
+      blockSize = block.size * 2;
+    }
+  }
+  if (blockSize < memReqs.size) {
+    blockSize = memReqs.size;
+  }
 
-  VkBufferCopy copyRegion{};
-  copyRegion.srcOffset = 0;
-  copyRegion.dstOffset = 0;
-  copyRegion.size = size;
-  vkCmdCopyBuffer(cmd, srcBuffer, dstBuffer, 1, &copyRegion);
+  VkMemoryAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = blockSize;
+  allocInfo.memoryTypeIndex = typeIndex;
 
-  vkEndCommandBuffer(cmd);
+  ArenaBlock block;
+  block.size = blockSize;
+  block.memoryTypeIndex = typeIndex;
+  if (vkAllocateMemory(vkDevice, &allocInfo, nullptr, &block.memory) !=
+      VK_SUCCESS) {
+    std::cerr << "Failed to allocate " << blockSize
+              << " byte arena block (memory type " << typeIndex << ")"
+              << std::endl;
+    return false;
+  }
 
-  VkSubmitInfo submitInfo{};
-  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &cmd;
+  // Host-visible blocks are mapped once for their lifetime; Vulkan allows at
+  // most one mapping per VkDeviceMemory, so per-upload map/unmap would break
+  // as soon as two buffers shared a block anyway
+  if (memoryProperties.memoryTypes[typeIndex].propertyFlags &
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+    if (vkMapMemory(vkDevice, block.memory, 0, VK_WHOLE_SIZE, 0,
+                    &block.mapped) != VK_SUCCESS) {
+      vkFreeMemory(vkDevice, block.memory, nullptr);
+      return false;
+    }
+  }
 
-  vkQueueSubmit(vkComputeQueue, 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(vkComputeQueue);
+  if (memReqs.size < blockSize) {
+    block.freeRanges.emplace_back(memReqs.size, blockSize - memReqs.size);
+  }
+  arenaBlocks_.push_back(std::move(block));
 
-  vkFreeCommandBuffers(vkDevice, vkCommandPool, 1, &cmd);
+  out.blockIndex = static_cast<int>(arenaBlocks_.size() - 1);
+  out.offset = 0;
+  out.size = memReqs.size;
   return true;
 }
 
+void VulkanRenderer::arenaFree(const ArenaAllocation &alloc) {
+  if (alloc.blockIndex < 0 ||
+      alloc.blockIndex >= static_cast<int>(arenaBlocks_.size())) {
+    return;
+  }
+  ArenaBlock &block = arenaBlocks_[alloc.blockIndex];
+
+  // Insert sorted by offset, then merge with whichever neighbors touch
+  auto it = std::lower_bound(
+      block.freeRanges.begin(), block.freeRanges.end(),
+      std::make_pair(alloc.offset, alloc.size));
+  it = block.freeRanges.insert(it, {alloc.offset, alloc.size});
+
+  if (it + 1 != block.freeRanges.end() &&
+      it->first + it->second == (it + 1)->first) {
+    it->second += (it + 1)->second;
+    block.freeRanges.erase(it + 1);
+  }
+  if (it != block.freeRanges.begin() &&
+      (it - 1)->first + (it - 1)->second == it->first) {
+    (it - 1)->second += it->second;
+    block.freeRanges.erase(it);
+  }
+}
+
+void *VulkanRenderer::arenaMappedPtr(VkBuffer buffer) {
+  auto it = arenaAllocations_.find(buffer);
+  if (it == arenaAllocations_.end()) {
+    return nullptr;
+  }
+  ArenaBlock &block = arenaBlocks_[it->second.blockIndex];
+  if (block.mapped == nullptr) {
+    return nullptr;
+  }
+  return static_cast<uint8_t *>(block.mapped) + it->second.offset;
+}
+
+void VulkanRenderer::destroyArenaBuffer(VkBuffer &buffer,
+                                        VkDeviceMemory &memory) {
+  if (buffer != VK_NULL_HANDLE) {
+    auto it = arenaAllocations_.find(buffer);
+    vkDestroyBuffer(vkDevice, buffer, nullptr);
+    if (it != arenaAllocations_.end()) {
+      arenaFree(it->second);
+      arenaAllocations_.erase(it);
+    }
+    buffer = VK_NULL_HANDLE;
+  }
+  // The handle aliased the block's memory - just drop the alias
+  memory = VK_NULL_HANDLE;
+}
+
+void VulkanRenderer::destroyArena() {
+  for (ArenaBlock &block : arenaBlocks_) {
+    if (block.mapped != nullptr) {
+      vkUnmapMemory(vkDevice, block.memory);
+    }
+    vkFreeMemory(vkDevice, block.memory, nullptr);
+  }
+  arenaBlocks_.clear();
+  arenaAllocations_.clear();
+}
+
 void VulkanRenderer::present() {
-  // Skip if no swapchain
+  // Skip if no swapchain (render() already fenced and advanced the frame)
   if (vkSwapchain == VK_NULL_HANDLE) {
     return;
   }
 
-  // Blit compute output to swapchain
+  // Direct-write frames were traced into the swapchain image and fenced by
+  // the compute submit - nothing left but the present itself
+  if (directPresentPending_) {
+    directPresentPending_ = false;
+
+    VkPresentInfoKHR presentInfo{};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &vkRenderFinishedSemaphores[currentFrame];
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &vkSwapchain;
+    presentInfo.pImageIndices = &currentImageIndex;
+
+    VkResult result = vkQueuePresentKHR(vkComputeQueue, &presentInfo);
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+      std::cerr << "Swapchain present failed with result " << result
+                << std::endl;
+    }
+
+    currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    return;
+  }
+
+  // Blit compute output to swapchain; the blit submit signals this frame's
+  // fence
   if (!blitToSwapchain()) {
     std::cerr << "Failed to blit to swapchain" << std::endl;
+
+    // The blit never reached its fenced submit - signal the fence with an
+    // empty submit so the next use of this frame slot doesn't deadlock
+    VkSubmitInfo emptySubmit{};
+    emptySubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    vkQueueSubmit(vkComputeQueue, 1, &emptySubmit,
+                  vkInFlightFences[currentFrame]);
   }
+
+  // Advance to next frame
+  currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
 bool VulkanRenderer::blitToSwapchain() {
@@ -1238,15 +3341,10 @@ bool VulkanRenderer::blitToSwapchain() {
     return false;
   }
 
-  // Create a command buffer for the blit operation
-  VkCommandBufferAllocateInfo allocInfo{};
-  allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  allocInfo.commandPool = vkCommandPool;
-  allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  allocInfo.commandBufferCount = 1;
-
-  VkCommandBuffer blitCmd;
-  vkAllocateCommandBuffers(vkDevice, &allocInfo, &blitCmd);
+  // Record into this frame's pre-allocated blit command buffer (safe to
+  // reset: render() waited on the frame slot's fence)
+  VkCommandBuffer blitCmd = vkBlitCommandBuffers[currentFrame];
+  vkResetCommandBuffer(blitCmd, 0);
 
   VkCommandBufferBeginInfo beginInfo{};
   beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -1254,6 +3352,13 @@ bool VulkanRenderer::blitToSwapchain() {
 
   vkBeginCommandBuffer(blitCmd, &beginInfo);
 
+  if (timestampsSupported) {
+    uint32_t query = timingQueryIndex(currentFrame, TIMING_STAGE_BLIT);
+    vkCmdResetQueryPool(blitCmd, vkTimestampQueryPool, query, 2);
+    vkCmdWriteTimestamp(blitCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        vkTimestampQueryPool, query);
+  }
+
   // Transition compute output image to TRANSFER_SRC_OPTIMAL
   VkImageMemoryBarrier barrier1{};
   barrier1.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -1290,9 +3395,11 @@ bool VulkanRenderer::blitToSwapchain() {
   VkImageBlit blitRegion{};
   blitRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
   blitRegion.srcSubresource.layerCount = 1;
+  // Source is the traced region only; when dynamic resolution has scaled it
+  // down, this linear-filtered blit is the upsample pass
   blitRegion.srcOffsets[0] = {0, 0, 0};
-  blitRegion.srcOffsets[1] = {static_cast<int32_t>(windowWidth),
-                              static_cast<int32_t>(windowHeight), 1};
+  blitRegion.srcOffsets[1] = {static_cast<int32_t>(renderWidth_),
+                              static_cast<int32_t>(renderHeight_), 1};
   blitRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
   blitRegion.dstSubresource.layerCount = 1;
   blitRegion.dstOffsets[0] = {0, 0, 0};
@@ -1337,11 +3444,18 @@ bool VulkanRenderer::blitToSwapchain() {
                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0,
                        nullptr, 1, &barrier4);
 
+  if (timestampsSupported) {
+    vkCmdWriteTimestamp(blitCmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        vkTimestampQueryPool,
+                        timingQueryIndex(currentFrame, TIMING_STAGE_BLIT) + 1);
+    timingQueryIssued[currentFrame][TIMING_STAGE_BLIT] = true;
+  }
+
   vkEndCommandBuffer(blitCmd);
 
-  // Submit the blit command buffer
-  VkPipelineStageFlags waitStages[] = {
-      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+  // Submit the blit command buffer (wait for the acquired image at the
+  // transfer stage, where the blit writes it)
+  VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_TRANSFER_BIT};
   VkSubmitInfo submitInfo{};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submitInfo.waitSemaphoreCount = 1;
@@ -1352,8 +3466,9 @@ bool VulkanRenderer::blitToSwapchain() {
   submitInfo.signalSemaphoreCount = 1;
   submitInfo.pSignalSemaphores = &vkRenderFinishedSemaphores[currentFrame];
 
-  vkQueueSubmit(vkComputeQueue, 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(vkComputeQueue);
+  // The fence makes the whole frame (upload, compute, blit) retire together;
+  // no queue drain needed, the next frame overlaps with this one
+  vkQueueSubmit(vkComputeQueue, 1, &submitInfo, vkInFlightFences[currentFrame]);
 
   // Present the image
   VkPresentInfoKHR presentInfo{};
@@ -1365,16 +3480,35 @@ bool VulkanRenderer::blitToSwapchain() {
   presentInfo.pImageIndices = &currentImageIndex;
 
   result = vkQueuePresentKHR(vkComputeQueue, &presentInfo);
+  if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+    std::cerr << "Swapchain present failed with result " << result << std::endl;
+  }
 
-  vkFreeCommandBuffers(vkDevice, vkCommandPool, 1, &blitCmd);
-
-  return (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR);
+  // The fenced submit went through, so the frame slot is accounted for even
+  // if presentation itself failed
+  return true;
 }
 
 void VulkanRenderer::shutdown() {
+  // Stop the hot-reload watcher before tearing down anything it could touch
+  if (shaderWatchThread_.joinable()) {
+    shaderWatchStop_.store(true);
+    shaderWatchThread_.join();
+  }
+
   if (vkDevice != VK_NULL_HANDLE) {
     vkDeviceWaitIdle(vkDevice);
 
+    // Unadopted and retired hot-reload pipelines
+    VkPipeline pending = pendingComputePipeline_.exchange(VK_NULL_HANDLE);
+    if (pending != VK_NULL_HANDLE) {
+      vkDestroyPipeline(vkDevice, pending, nullptr);
+    }
+    for (const auto &retired : retiredPipelines_) {
+      vkDestroyPipeline(vkDevice, retired.first, nullptr);
+    }
+    retiredPipelines_.clear();
+
     // Clean up fences
     for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
       if (vkInFlightFences[i] != VK_NULL_HANDLE) {
@@ -1411,6 +3545,17 @@ void VulkanRenderer::shutdown() {
     }
     vkRenderFinishedSemaphores.clear();
 
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+      if (vkUploadSemaphores[i] != VK_NULL_HANDLE) {
+        vkDestroySemaphore(vkDevice, vkUploadSemaphores[i], nullptr);
+        vkUploadSemaphores[i] = VK_NULL_HANDLE;
+      }
+      for (auto &[stagingBuf, stagingMem] : retiredStagingBuffers[i]) {
+        destroyArenaBuffer(stagingBuf, stagingMem);
+      }
+      retiredStagingBuffers[i].clear();
+    }
+
     // Only destroy resources that were successfully created
     if (vkOutputImageView != VK_NULL_HANDLE) {
       vkDestroyImageView(vkDevice, vkOutputImageView, nullptr);
@@ -1425,55 +3570,78 @@ void VulkanRenderer::shutdown() {
       vkOutputImageMemory = VK_NULL_HANDLE;
     }
 
-    if (vkSphereBuffer != VK_NULL_HANDLE) {
-      vkDestroyBuffer(vkDevice, vkSphereBuffer, nullptr);
-      vkSphereBuffer = VK_NULL_HANDLE;
-    }
-    if (vkSphereBufferMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(vkDevice, vkSphereBufferMemory, nullptr);
-      vkSphereBufferMemory = VK_NULL_HANDLE;
-    }
-
-    if (vkEllipsoidBuffer != VK_NULL_HANDLE) {
-      vkDestroyBuffer(vkDevice, vkEllipsoidBuffer, nullptr);
-      vkEllipsoidBuffer = VK_NULL_HANDLE;
-    }
-    if (vkEllipsoidBufferMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(vkDevice, vkEllipsoidBufferMemory, nullptr);
-      vkEllipsoidBufferMemory = VK_NULL_HANDLE;
+    if (vkAccumImageView != VK_NULL_HANDLE) {
+      vkDestroyImageView(vkDevice, vkAccumImageView, nullptr);
+      vkAccumImageView = VK_NULL_HANDLE;
     }
-
-    if (vkMaterialBuffer != VK_NULL_HANDLE) {
-      vkDestroyBuffer(vkDevice, vkMaterialBuffer, nullptr);
-      vkMaterialBuffer = VK_NULL_HANDLE;
+    if (vkAccumImage != VK_NULL_HANDLE) {
+      vkDestroyImage(vkDevice, vkAccumImage, nullptr);
+      vkAccumImage = VK_NULL_HANDLE;
     }
-    if (vkMaterialBufferMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(vkDevice, vkMaterialBufferMemory, nullptr);
-      vkMaterialBufferMemory = VK_NULL_HANDLE;
+    if (vkAccumImageMemory != VK_NULL_HANDLE) {
+      vkFreeMemory(vkDevice, vkAccumImageMemory, nullptr);
+      vkAccumImageMemory = VK_NULL_HANDLE;
     }
 
-    if (vkLightBuffer != VK_NULL_HANDLE) {
-      vkDestroyBuffer(vkDevice, vkLightBuffer, nullptr);
-      vkLightBuffer = VK_NULL_HANDLE;
+    // Buffers live in the arena; their memory handles are block aliases
+    destroyArenaBuffer(vkSphereBuffer, vkSphereBufferMemory);
+    destroyArenaBuffer(vkEllipsoidBuffer, vkEllipsoidBufferMemory);
+    destroyArenaBuffer(vkMaterialBuffer, vkMaterialBufferMemory);
+    destroyArenaBuffer(vkLightBuffer, vkLightBufferMemory);
+    destroyArenaBuffer(vkSampleBuffer, vkSampleBufferMemory);
+    destroyArenaBuffer(vkAnimationBuffer, vkAnimationBufferMemory);
+
+    stagingRingMapped = nullptr;
+    destroyArenaBuffer(vkStagingRingBuffer, vkStagingRingMemory);
+
+    destroyArenaBuffer(vkTriangleBuffer, vkTriangleBufferMemory);
+    destroyArenaBuffer(vkBVHNodeBuffer, vkBVHNodeBufferMemory);
+    destroyArenaBuffer(vkBVHIndexBuffer, vkBVHIndexBufferMemory);
+    destroyArenaBuffer(vkVolumeBuffer, vkVolumeBufferMemory);
+    destroyArenaBuffer(vkOccupancyBuffer, vkOccupancyBufferMemory);
+
+    if (vkVolumeDensitySampler != VK_NULL_HANDLE) {
+      vkDestroySampler(vkDevice, vkVolumeDensitySampler, nullptr);
+      vkVolumeDensitySampler = VK_NULL_HANDLE;
     }
-    if (vkLightBufferMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(vkDevice, vkLightBufferMemory, nullptr);
-      vkLightBufferMemory = VK_NULL_HANDLE;
+    if (vkVolumeDensityImageView != VK_NULL_HANDLE) {
+      vkDestroyImageView(vkDevice, vkVolumeDensityImageView, nullptr);
+      vkVolumeDensityImageView = VK_NULL_HANDLE;
     }
-
-    if (vkVolumeBuffer != VK_NULL_HANDLE) {
-      vkDestroyBuffer(vkDevice, vkVolumeBuffer, nullptr);
-      vkVolumeBuffer = VK_NULL_HANDLE;
+    if (vkVolumeDensityImage != VK_NULL_HANDLE) {
+      vkDestroyImage(vkDevice, vkVolumeDensityImage, nullptr);
+      vkVolumeDensityImage = VK_NULL_HANDLE;
     }
-    if (vkVolumeBufferMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(vkDevice, vkVolumeBufferMemory, nullptr);
-      vkVolumeBufferMemory = VK_NULL_HANDLE;
+    if (vkVolumeDensityImageMemory != VK_NULL_HANDLE) {
+      vkFreeMemory(vkDevice, vkVolumeDensityImageMemory, nullptr);
+      vkVolumeDensityImageMemory = VK_NULL_HANDLE;
     }
 
     if (vkComputePipeline != VK_NULL_HANDLE) {
       vkDestroyPipeline(vkDevice, vkComputePipeline, nullptr);
       vkComputePipeline = VK_NULL_HANDLE;
     }
+    if (vkAnimPipeline != VK_NULL_HANDLE) {
+      vkDestroyPipeline(vkDevice, vkAnimPipeline, nullptr);
+      vkAnimPipeline = VK_NULL_HANDLE;
+    }
+    if (vkAnimPipelineLayout != VK_NULL_HANDLE) {
+      vkDestroyPipelineLayout(vkDevice, vkAnimPipelineLayout, nullptr);
+      vkAnimPipelineLayout = VK_NULL_HANDLE;
+    }
+    if (vkAnimDescriptorSetLayout != VK_NULL_HANDLE) {
+      vkDestroyDescriptorSetLayout(vkDevice, vkAnimDescriptorSetLayout,
+                                   nullptr);
+      vkAnimDescriptorSetLayout = VK_NULL_HANDLE;
+    }
+    if (vkPipelineCache != VK_NULL_HANDLE) {
+      vkDestroyPipelineCache(vkDevice, vkPipelineCache, nullptr);
+      vkPipelineCache = VK_NULL_HANDLE;
+    }
+    if (vkTimestampQueryPool != VK_NULL_HANDLE) {
+      vkDestroyQueryPool(vkDevice, vkTimestampQueryPool, nullptr);
+      vkTimestampQueryPool = VK_NULL_HANDLE;
+    }
     if (vkPipelineLayout != VK_NULL_HANDLE) {
       vkDestroyPipelineLayout(vkDevice, vkPipelineLayout, nullptr);
       vkPipelineLayout = VK_NULL_HANDLE;
@@ -1481,6 +3649,8 @@ void VulkanRenderer::shutdown() {
     if (vkDescriptorPool != VK_NULL_HANDLE) {
       vkDestroyDescriptorPool(vkDevice, vkDescriptorPool, nullptr);
       vkDescriptorPool = VK_NULL_HANDLE;
+      vkSwapchainDescriptorSets_.clear();
+      vkAnimDescriptorSet = VK_NULL_HANDLE;
     }
     if (vkDescriptorSetLayout != VK_NULL_HANDLE) {
       vkDestroyDescriptorSetLayout(vkDevice, vkDescriptorSetLayout, nullptr);
@@ -1492,15 +3662,18 @@ void VulkanRenderer::shutdown() {
       vkCommandPool = VK_NULL_HANDLE;
     }
 
-    if (vkReadbackBuffer != VK_NULL_HANDLE) {
-      vkDestroyBuffer(vkDevice, vkReadbackBuffer, nullptr);
-      vkReadbackBuffer = VK_NULL_HANDLE;
+    if (vkTransferCommandPool != VK_NULL_HANDLE) {
+      vkDestroyCommandPool(vkDevice, vkTransferCommandPool, nullptr);
+      vkTransferCommandPool = VK_NULL_HANDLE;
     }
-    if (vkReadbackBufferMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(vkDevice, vkReadbackBufferMemory, nullptr);
-      vkReadbackBufferMemory = VK_NULL_HANDLE;
+
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+      readbackMapped[i] = nullptr;
+      destroyArenaBuffer(vkReadbackBuffers[i], vkReadbackBufferMemory[i]);
     }
 
+    destroyArena();
+
     vkDestroyDevice(vkDevice, nullptr);
     vkDevice = VK_NULL_HANDLE;
   }
@@ -0,0 +1,313 @@
+// Headless benchmark harness for the Vulkan renderer. Runs scripted
+// workloads - sphere-count scaling through updateScene, the walnut volume at
+// several march lengths, and the turntable orbit from main_vulkan as a
+// deterministic camera path - then reports per-workload frame-time
+// mean/p50/p99 on stdout and writes machine-readable JSON for regression
+// tracking in CI.
+//
+// Usage: PathTracerBench [--frames N] [--json <path>]
+//
+// Frame times are wall-clock around render(): with two frames in flight the
+// fence wait inside render() paces the loop at GPU throughput, so the steady
+// state measures the tracer, not the CPU.
+
+#include "SceneWrappers.h"
+#include "VulkanRenderer.h"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <execution>
+#include <fstream>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int BENCH_WIDTH = 800;
+const int BENCH_HEIGHT = 600;
+const int MAX_DEPTH = 5;
+const int WARMUP_FRAMES = 8;
+
+struct WorkloadResult {
+  std::string name;
+  int frames = 0;
+  double meanMs = 0.0;
+  double p50Ms = 0.0;
+  double p99Ms = 0.0;
+};
+
+double percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Deterministic turntable: the same orbit main_vulkan drives interactively,
+// but keyed off the frame index so every run walks the identical path
+void fillCameraConstants(PushConstants &pc, int frame) {
+  const double orbitRadius = 3.0;
+  const glm::vec3 lookCenter(2.0f, 1.5f, 0.0f);
+  double theta = frame / 180.0;
+
+  glm::vec3 eye(2.0 + orbitRadius * std::cos(theta), 1.5,
+                6.0 + orbitRadius * std::sin(theta));
+  glm::mat4 view = glm::lookAt(eye, lookCenter, glm::vec3(0.0f, 1.0f, 0.0f));
+  glm::mat4 proj = glm::perspective(
+      glm::radians(60.0f),
+      static_cast<float>(BENCH_WIDTH) / BENCH_HEIGHT, 0.1f, 100.0f);
+  pc.cameraMatrix = proj * view;
+  pc.cameraPos = eye;
+  pc.time = static_cast<float>(frame) * (1000.0f / 120.0f);
+}
+
+WorkloadResult runWorkload(VulkanRenderer &renderer, const std::string &name,
+                           int frames, PushConstants pc) {
+  pc.maxDepth = MAX_DEPTH;
+  pc.bgColorBottom = glm::vec3(1.0f, 1.0f, 1.0f);
+  pc.bgColorTop = glm::vec3(0.4f, 0.45f, 1.0f);
+
+  // Untimed warmup so scene uploads, first-use layout transitions, and the
+  // in-flight pipeline settle before sampling starts
+  for (int frame = 0; frame < WARMUP_FRAMES; frame++) {
+    fillCameraConstants(pc, frame);
+    renderer.render(pc);
+  }
+
+  std::vector<double> samples;
+  samples.reserve(frames);
+  for (int frame = 0; frame < frames; frame++) {
+    fillCameraConstants(pc, WARMUP_FRAMES + frame);
+    auto start = std::chrono::steady_clock::now();
+    renderer.render(pc);
+    auto end = std::chrono::steady_clock::now();
+    samples.push_back(
+        std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  std::sort(samples.begin(), samples.end());
+
+  WorkloadResult result;
+  result.name = name;
+  result.frames = frames;
+  for (double ms : samples) {
+    result.meanMs += ms;
+  }
+  result.meanMs /= samples.size();
+  result.p50Ms = percentile(samples, 0.50);
+  result.p99Ms = percentile(samples, 0.99);
+
+  std::printf("%-24s %6d frames  mean %7.3f ms  p50 %7.3f ms  p99 %7.3f ms\n",
+              result.name.c_str(), result.frames, result.meanMs, result.p50Ms,
+              result.p99Ms);
+  return result;
+}
+
+// Grid of spheres cycling through a small material set, plus a ground
+// sphere - the sphere-count scaling workload
+void buildSphereScene(int count, std::vector<GPUSphere> &outSpheres,
+                      std::vector<GPUMaterial> &outMaterials,
+                      std::vector<GPULight> &outLights,
+                      const std::unordered_map<std::string, int> &shaderMap) {
+  const Material palette[] = {
+      Material::Diffuse(glm::vec3(0.8f, 0.2f, 0.2f)),
+      Material::Diffuse(glm::vec3(0.8f, 0.8f, 0.2f)),
+      Material::Mirror(),
+      Material::Emissive(glm::vec3(0.2f, 0.8f, 0.2f), 2.0f),
+  };
+  const size_t paletteSize = sizeof(palette) / sizeof(palette[0]);
+
+  std::vector<Sphere> spheres;
+  spheres.reserve(count + 1);
+  int side = std::max(1, static_cast<int>(std::ceil(std::cbrt(count))));
+  for (int i = 0; i < count; i++) {
+    int x = i % side;
+    int y = (i / side) % side;
+    int z = i / (side * side);
+    glm::vec3 center(-2.0f + 4.0f * x / side, 0.0f + 3.0f * y / side,
+                     -3.0f + 4.0f * z / side);
+    spheres.push_back(Sphere(center, 1.5f / side, glm::vec3(1.0f),
+                             palette[i % paletteSize]));
+  }
+  spheres.push_back(Sphere(glm::vec3(0.0f, -100.5f, -1.0f), 100.0f,
+                           glm::vec3(0.8f, 0.8f, 0.2f), palette[1]));
+
+  std::vector<Material> materials;
+  SceneManager::prepareForRender(materials, spheres);
+
+  outSpheres.resize(spheres.size());
+  std::transform(std::execution::par_unseq, spheres.begin(), spheres.end(),
+                 outSpheres.begin(),
+                 [](const Sphere &sphere) { return sphere.toGPU(); });
+  outMaterials.resize(materials.size());
+  std::transform(materials.begin(), materials.end(), outMaterials.begin(),
+                 [&shaderMap](const Material &material) {
+                   return material.toGPU(shaderMap);
+                 });
+
+  outLights.clear();
+  outLights.push_back(
+      Light(glm::vec3(2.0f, 2.0f, 1.0f), 0.5f, glm::vec3(1.0f, 0.9f, 0.8f))
+          .toGPU());
+  outLights.push_back(
+      Light(glm::vec3(-2.0f, 1.0f, 0.0f), 0.5f, glm::vec3(0.3f, 0.5f, 1.0f))
+          .toGPU());
+}
+
+// Flat .dat/.raw loader (mirrors the one in main_vulkan)
+bool loadWalnut(std::vector<uint8_t> &volumeData, glm::ivec3 &resolution) {
+  std::ifstream datStream("volume/walnut.dat");
+  if (!datStream.is_open()) {
+    return false;
+  }
+  resolution = glm::ivec3(1);
+  std::string line;
+  while (std::getline(datStream, line)) {
+    int x, y, z;
+    if (sscanf(line.c_str(), "Resolution: %d %d %d", &x, &y, &z) == 3 ||
+        sscanf(line.c_str(), "Resolution:\t%d %d %d", &x, &y, &z) == 3) {
+      resolution = glm::ivec3(x, y, z);
+    }
+  }
+
+  std::ifstream rawStream("volume/walnut.raw", std::ios::binary);
+  if (!rawStream.is_open()) {
+    return false;
+  }
+  size_t expectedSize =
+      static_cast<size_t>(resolution.x) * resolution.y * resolution.z;
+  volumeData.resize(expectedSize);
+  rawStream.read(reinterpret_cast<char *>(volumeData.data()), expectedSize);
+  return static_cast<size_t>(rawStream.gcount()) == expectedSize;
+}
+
+void writeJson(const std::string &path, int framesPerWorkload,
+               const std::vector<WorkloadResult> &results) {
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    std::cerr << "Failed to write " << path << std::endl;
+    return;
+  }
+  out << "{\n";
+  out << "  \"width\": " << BENCH_WIDTH << ",\n";
+  out << "  \"height\": " << BENCH_HEIGHT << ",\n";
+  out << "  \"frames_per_workload\": " << framesPerWorkload << ",\n";
+  out << "  \"workloads\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    const WorkloadResult &r = results[i];
+    out << "    {\"name\": \"" << r.name << "\", \"frames\": " << r.frames
+        << ", \"mean_ms\": " << r.meanMs << ", \"p50_ms\": " << r.p50Ms
+        << ", \"p99_ms\": " << r.p99Ms << "}"
+        << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n";
+  out << "}\n";
+  std::cout << "Wrote " << path << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int framesPerWorkload = 240;
+  std::string jsonPath = "bench_results.json";
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--frames" && i + 1 < argc) {
+      framesPerWorkload = std::atoi(argv[++i]);
+    } else if (arg == "--json" && i + 1 < argc) {
+      jsonPath = argv[++i];
+    }
+  }
+
+  // SDL still initializes (the instance extension query goes through it),
+  // but no window is created - the renderer runs fully headless
+  if (!SDL_Init(SDL_INIT_VIDEO)) {
+    std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
+    return 1;
+  }
+
+  VulkanRenderer renderer;
+  renderer.setMaxBounceDepth(MAX_DEPTH);
+  if (!renderer.initialize(nullptr, BENCH_WIDTH, BENCH_HEIGHT)) {
+    std::cerr << "Vulkan renderer initialization failed" << std::endl;
+    SDL_Quit();
+    return 1;
+  }
+
+  const auto &shaderMap = renderer.getShaderPathToIndexMap();
+  std::vector<WorkloadResult> results;
+
+  // Sphere-count scaling: same materials and lights, BVH and shading load
+  // grow with the count
+  for (int count : {64, 512, 4096}) {
+    std::vector<GPUSphere> spheres;
+    std::vector<GPUMaterial> gpuMaterials;
+    std::vector<GPULight> lights;
+    buildSphereScene(count, spheres, gpuMaterials, lights, shaderMap);
+    renderer.updateScene(spheres, {}, gpuMaterials, lights, {});
+
+    PushConstants pc{};
+    pc.numSpheres = static_cast<int>(spheres.size());
+    pc.numLights = static_cast<int>(lights.size());
+    results.push_back(runWorkload(renderer, "spheres-" + std::to_string(count),
+                                  framesPerWorkload, pc));
+  }
+
+  // Walnut volume at several box extents: the march step is fixed in world
+  // units, so a larger box means proportionally more samples per ray
+  std::vector<uint8_t> volumeData;
+  glm::ivec3 volumeResolution;
+  if (loadWalnut(volumeData, volumeResolution)) {
+    const Material volumeMaterial =
+        Material::Volumetric(glm::vec3(0.8f, 0.6f, 0.4f), 8.0f);
+    for (float extent : {1.0f, 2.0f, 4.0f}) {
+      std::vector<VolumetricData> volumes;
+      volumes.push_back(VolumetricData(
+          glm::vec3(1.5f, 1.0f, -0.5f), 0.001f, glm::vec3(0.0f),
+          glm::vec3(extent), volumeResolution, volumeMaterial));
+      std::vector<Material> materials;
+      SceneManager::prepareForRender(materials, volumes);
+
+      std::vector<GPUMaterial> gpuMaterials;
+      gpuMaterials.push_back(materials[0].toGPU(shaderMap));
+      std::vector<GPUVolumetricData> gpuVolumes;
+      gpuVolumes.push_back(volumes[0].toGPU());
+      std::vector<GPULight> lights;
+      lights.push_back(
+          Light(glm::vec3(2.0f, 2.0f, 1.0f), 0.5f, glm::vec3(1.0f)).toGPU());
+      renderer.updateScene({}, {}, gpuMaterials, lights, gpuVolumes,
+                           volumeData);
+
+      PushConstants pc{};
+      pc.numLights = static_cast<int>(lights.size());
+      pc.numVolumes = static_cast<int>(gpuVolumes.size());
+      char name[48];
+      std::snprintf(name, sizeof(name), "volume-walnut-x%.0f", extent);
+      results.push_back(runWorkload(renderer, name, framesPerWorkload, pc));
+    }
+  } else {
+    std::cout << "volume/walnut.{dat,raw} not found, skipping volume "
+                 "workloads"
+              << std::endl;
+  }
+
+  writeJson(jsonPath, framesPerWorkload, results);
+
+  VulkanRenderer::GpuTimings timings = renderer.getGpuTimings();
+  std::printf("GPU compute (last window): avg %.3f ms  p50 %.3f ms  p95 %.3f "
+              "ms\n",
+              timings.compute.averageMs, timings.compute.p50Ms,
+              timings.compute.p95Ms);
+
+  renderer.shutdown();
+  SDL_Quit();
+  return 0;
+}
@@ -1,18 +1,32 @@
 #include "Camera.h"
+#include "CpuRenderer.h"
 #include "Ellipsoid.h"
 #include "Quaternion.h"
+#include "SceneFile.h"
 #include "SceneWrappers.h"
 #include "Vec3.h"
+#include "VolumeFile.h"
 #include "VulkanRenderer.h"
 
 #include <SDL3/SDL.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
 #include <execution>
+#include <filesystem>
 #include <fstream>
+#include <future>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <vector>
 
 // Window dimensions
@@ -22,11 +36,8 @@ const int WINDOW_HEIGHT = 600;
 // Maximum recursion depth for bounce lighting
 const int MAX_DEPTH = 5;
 
-// Helper function to load volumetric data from .dat and .raw files
-bool loadVolumetricData(const std::string &datFile, const std::string &rawFile,
-                        std::vector<uint8_t> &volumeData,
-                        glm::ivec3 &resolution) {
-  // Read .dat file to get metadata
+// Helper function to read the volume resolution from a .dat metadata file
+bool loadVolumeResolution(const std::string &datFile, glm::ivec3 &resolution) {
   std::ifstream datStream(datFile);
   if (!datStream.is_open()) {
     std::cerr << "Failed to open .dat file: " << datFile << std::endl;
@@ -49,7 +60,16 @@ bool loadVolumetricData(const std::string &datFile, const std::string &rawFile,
       }
     }
   }
-  datStream.close();
+  return true;
+}
+
+// Helper function to load volumetric data from .dat and .raw files
+bool loadVolumetricData(const std::string &datFile, const std::string &rawFile,
+                        std::vector<uint8_t> &volumeData,
+                        glm::ivec3 &resolution) {
+  if (!loadVolumeResolution(datFile, resolution)) {
+    return false;
+  }
 
   // Read raw binary data
   std::ifstream rawStream(rawFile, std::ios::binary);
@@ -81,6 +101,66 @@ glm::vec4 quaternionToGlm(const Quaternion &q) {
 }
 
 int main(int argc, char *argv[]) {
+  // Batch mode: --batch N renders N frames of the turntable path headlessly
+  // and streams them to --out <dir> (default "frames") as PPM files
+  int batchFrames = 0;
+  std::string batchOutDir = "frames";
+  bool logGpuTimings = false;
+  std::string scenePath;     // --scene: load a baked .ptsc instead
+  std::string bakeScenePath; // --bake-scene: write the scene and exit
+  double dynamicResMs = 0.0; // --dynamic-res: target compute ms, 0 = off
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--batch" && i + 1 < argc) {
+      batchFrames = std::atoi(argv[++i]);
+    } else if (arg == "--out" && i + 1 < argc) {
+      batchOutDir = argv[++i];
+    } else if (arg == "--gpu-timings") {
+      logGpuTimings = true;
+    } else if (arg == "--dynamic-res" && i + 1 < argc) {
+      dynamicResMs = std::atof(argv[++i]);
+    } else if (arg == "--scene" && i + 1 < argc) {
+      scenePath = argv[++i];
+    } else if (arg == "--bake-scene" && i + 1 < argc) {
+      bakeScenePath = argv[++i];
+    } else if (arg == "--convert-volume" && i + 3 < argc) {
+      // Offline conversion: repack a flat .dat/.raw volume into the bricked
+      // .ptvb layout and exit
+      std::string datFile = argv[++i];
+      std::string rawFile = argv[++i];
+      std::string outFile = argv[++i];
+      glm::ivec3 resolution;
+      if (!loadVolumeResolution(datFile, resolution) ||
+          !VolumeFile::convert(rawFile, resolution, outFile)) {
+        return 1;
+      }
+      return 0;
+    }
+  }
+
+  // Kick the volume read off before anything else: disk IO and
+  // SDL/Vulkan/shader setup (including the glslc shell-out) are independent,
+  // so the 40+ MB walnut read overlaps them instead of serializing after. A
+  // bricked .ptvb next to the raw files is preferred: it memory-maps instead
+  // of loading the whole volume, and the renderer streams only its occupied
+  // bricks to the GPU. Nothing touches these variables again until
+  // finishVolumeLoad has joined the future.
+  std::vector<uint8_t> volumeData;
+  glm::ivec3 volumeResolution;
+  std::string datPath = "volume/walnut.dat";
+  std::string rawPath = "volume/walnut.raw";
+  std::string ptvbPath = "volume/walnut.ptvb";
+  VolumeFile volumeFile; // Stays mapped until the bricks are uploaded
+  bool volumeLoaded = false;
+  std::future<bool> volumeLoadFuture = std::async(std::launch::async, [&]() {
+    if (volumeFile.open(ptvbPath)) {
+      volumeResolution = volumeFile.resolution();
+      std::cout << "Mapped bricked volume: " << ptvbPath << std::endl;
+      return true;
+    }
+    return loadVolumetricData(datPath, rawPath, volumeData, volumeResolution);
+  });
+
   // Initialize SDL
   if (!SDL_Init(SDL_INIT_VIDEO)) {
     std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
@@ -89,26 +169,52 @@ int main(int argc, char *argv[]) {
 
   std::cout << "SDL initialized successfully" << std::endl;
 
-  // Create window with Vulkan support
-  SDL_Window *window = SDL_CreateWindow("Path Tracer (Vulkan)", WINDOW_WIDTH,
-                                        WINDOW_HEIGHT, SDL_WINDOW_VULKAN);
-
-  if (!window) {
-    std::cerr << "Window creation failed: " << SDL_GetError() << std::endl;
-    std::cerr << "Continuing in headless mode..." << std::endl;
-    // Continue anyway - we can render without displaying
+  // Create window with Vulkan support (batch mode stays windowless)
+  SDL_Window *window = nullptr;
+  if (batchFrames > 0) {
+    std::cout << "Batch mode: rendering " << batchFrames << " frames to "
+              << batchOutDir << std::endl;
   } else {
-    std::cout << "Window created successfully" << std::endl;
+    window = SDL_CreateWindow("Path Tracer (Vulkan)", WINDOW_WIDTH,
+                              WINDOW_HEIGHT, SDL_WINDOW_VULKAN);
+
+    if (!window) {
+      std::cerr << "Window creation failed: " << SDL_GetError() << std::endl;
+      std::cerr << "Continuing in headless mode..." << std::endl;
+      // Continue anyway - we can render without displaying
+    } else {
+      std::cout << "Window created successfully" << std::endl;
+    }
   }
 
-  // Initialize Vulkan renderer
+  // Initialize Vulkan renderer (bounce depth is baked into the pipeline as a
+  // specialization constant, so it must be set before initialize)
   VulkanRenderer vulkanRenderer;
+  vulkanRenderer.setMaxBounceDepth(MAX_DEPTH);
+  std::unique_ptr<CpuRenderer> cpuRenderer;
   if (!vulkanRenderer.initialize(window, WINDOW_WIDTH, WINDOW_HEIGHT)) {
-    std::cerr << "Vulkan renderer initialization failed" << std::endl;
-    if (window)
+    std::cerr << "Vulkan renderer initialization failed, falling back to the "
+                 "CPU engine"
+              << std::endl;
+    cpuRenderer = std::make_unique<CpuRenderer>(WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    // The Vulkan-flagged window can't take a software blit; swap it for a
+    // plain one (likely Vulkan is missing entirely and creation failed too)
+    if (window) {
       SDL_DestroyWindow(window);
-    SDL_Quit();
-    return 1;
+      window = SDL_CreateWindow("Path Tracer (CPU)", WINDOW_WIDTH,
+                                WINDOW_HEIGHT, 0);
+      if (!window) {
+        std::cerr << "Window creation failed: " << SDL_GetError() << std::endl;
+        std::cerr << "Continuing in headless mode..." << std::endl;
+      }
+    }
+  }
+
+  if (logGpuTimings && !cpuRenderer) {
+    // Print rolling per-stage GPU timings (upload/compute/blit) twice a
+    // second at the 120 Hz target
+    vulkanRenderer.setGpuTimingLogInterval(60);
   }
 
   // Initialize SDL renderer and texture for display (no longer needed with
@@ -128,6 +234,7 @@ int main(int argc, char *argv[]) {
   // Create scene with objects using wrapper classes
   std::vector<Sphere> spheres;
   std::vector<Ellipsoid> ellipsoids;
+  std::vector<Mesh> meshes;
   std::vector<Light> lights;
   std::vector<VolumetricData> volumes;
 
@@ -197,6 +304,17 @@ int main(int argc, char *argv[]) {
                                  glm::vec3(0.4f, 0.8f, 0.8f), // Cyan color
                                  blueMat));                   // Blue material
 
+  // Mesh definition: a small tetrahedron exercising the triangle path
+  // (indexed geometry, flattened to GPUTriangles before upload)
+  meshes.push_back(Mesh(
+      {
+          glm::vec3(3.2f, -0.5f, -0.2f),
+          glm::vec3(4.0f, -0.5f, -0.6f),
+          glm::vec3(3.4f, -0.5f, -1.1f),
+          glm::vec3(3.5f, 0.5f, -0.6f),
+      },
+      {0, 1, 2, 0, 3, 1, 1, 3, 2, 2, 3, 0}, redMat));
+
   // Light definitions using wrapper class
   lights.push_back(Light(glm::vec3(2.0f, 2.0f, 1.0f), 0.5f,
                          glm::vec3(1.0f, 0.9f, 0.8f))); // Warm light
@@ -207,31 +325,22 @@ int main(int argc, char *argv[]) {
   lights.push_back(Light(glm::vec3(0.0f, -0.2f, 0.5f), 0.5f,
                          glm::vec3(1.0f, 0.4f, 0.4f))); // Red accent light
 
-  // Load volumetric data (walnut)
-  std::vector<uint8_t> volumeData;
-  glm::ivec3 volumeResolution;
-  std::string datPath = "volume/walnut.dat";
-  std::string rawPath = "volume/walnut.raw";
-
-  if (loadVolumetricData(datPath, rawPath, volumeData, volumeResolution)) {
-    VolumetricData volData(
-        glm::vec3(1.5f, 1.0f, -0.5f), // Position where camera is looking
-        0.001f,                       // Scale factor
-        glm::vec3(0.0f, 0.0f, 0.0f), // Volume min corner (relative to position)
-        glm::vec3(2.0f, 2.0f, 2.0f), // Volume max corner (2-unit cube)
-        volumeResolution,            // Resolution from file
-        volumetricMat);              // Material reference
-    volumes.push_back(volData);
-    std::cout << "Volumetric data loaded and added to scene" << std::endl;
-  } else {
-    std::cerr << "Warning: Failed to load volumetric data, continuing without "
-                 "volume"
-              << std::endl;
-  }
+  // The walnut volume enters the scene immediately with a placeholder
+  // resolution so its material index resolves in prepareForRender; the
+  // background read started at program start fills in the real resolution
+  // (or removes the volume) when it is joined.
+  volumes.push_back(VolumetricData(
+      glm::vec3(1.5f, 1.0f, -0.5f), // Position where camera is looking
+      0.001f,                       // Scale factor
+      glm::vec3(0.0f, 0.0f, 0.0f),  // Volume min corner (relative to position)
+      glm::vec3(2.0f, 2.0f, 2.0f),  // Volume max corner (2-unit cube)
+      glm::ivec3(1),                // Placeholder until the read is joined
+      volumetricMat));              // Material reference
 
   // Pre-render: Build material list and map object materials to indices
   std::vector<Material> materials;
-  SceneManager::prepareForRender(materials, spheres, ellipsoids, volumes);
+  SceneManager::prepareForRender(materials, spheres, ellipsoids, meshes,
+                                 volumes);
 
   std::cout << "Pre-render complete: " << materials.size()
             << " unique materials collected" << std::endl;
@@ -270,6 +379,12 @@ int main(int argc, char *argv[]) {
                  ellipsoids.end(), gpuEllipsoids.begin(),
                  [](const Ellipsoid &ellipsoid) { return ellipsoid.toGPU(); });
 
+  // Flatten meshes into one triangle list (serial: appends are ordered)
+  std::vector<GPUTriangle> gpuTriangles;
+  for (const auto &mesh : meshes) {
+    mesh.appendGPUTriangles(gpuTriangles);
+  }
+
   // Get shader path to index mapping from renderer
   const auto &shaderPathToIndex = vulkanRenderer.getShaderPathToIndexMap();
 
@@ -290,33 +405,303 @@ int main(int argc, char *argv[]) {
                  gpuVolumes.begin(),
                  [](const VolumetricData &volume) { return volume.toGPU(); });
 
-  // Update scene in GPU
-  vulkanRenderer.updateScene(gpuSpheres, gpuEllipsoids, gpuMaterials, gpuLights,
-                             gpuVolumes, volumeData);
+  // Baked binary scene: the records are the GPU structs themselves, so a
+  // load is one mmap plus bulk copies into the upload vectors - no
+  // per-object conversion, regardless of scene size
+  bool bakedSceneLoaded = false;
+  if (!scenePath.empty()) {
+    SceneFile bakedScene;
+    if (bakedScene.open(scenePath)) {
+      bakedSceneLoaded = true;
+      gpuSpheres.assign(bakedScene.spheres(),
+                        bakedScene.spheres() + bakedScene.sphereCount());
+      gpuEllipsoids.assign(bakedScene.ellipsoids(),
+                           bakedScene.ellipsoids() +
+                               bakedScene.ellipsoidCount());
+      gpuMaterials.assign(bakedScene.materials(),
+                          bakedScene.materials() + bakedScene.materialCount());
+      gpuLights.assign(bakedScene.lights(),
+                       bakedScene.lights() + bakedScene.lightCount());
+      gpuVolumes.assign(bakedScene.volumes(),
+                        bakedScene.volumes() + bakedScene.volumeCount());
+      std::cout << "Loaded baked scene: " << gpuSpheres.size() << " spheres, "
+                << gpuEllipsoids.size() << " ellipsoids, "
+                << gpuMaterials.size() << " materials, " << gpuLights.size()
+                << " lights, " << gpuVolumes.size() << " volumes from "
+                << scenePath << std::endl;
+    } else {
+      std::cerr << "Failed to open scene file " << scenePath
+                << ", using the built-in scene" << std::endl;
+    }
+  }
+
+  // Join the background volume read: patch the real resolution into the
+  // built-in volume record (baked scenes already carry finished records) or
+  // drop the volume if the files were missing. Safe to call repeatedly; only
+  // the first call blocks.
+  auto finishVolumeLoad = [&]() {
+    if (!volumeLoadFuture.valid()) {
+      return volumeLoaded;
+    }
+    volumeLoaded = volumeLoadFuture.get();
+    if (volumeLoaded && !volumes.empty()) {
+      volumes[0].setResolution(volumeResolution);
+      if (!bakedSceneLoaded) {
+        gpuVolumes.assign(1, volumes[0].toGPU());
+      }
+      std::cout << "Volumetric data loaded and added to scene" << std::endl;
+    } else if (!bakedSceneLoaded) {
+      volumes.clear();
+      gpuVolumes.clear();
+      std::cerr << "Warning: Failed to load volumetric data, continuing "
+                   "without volume"
+                << std::endl;
+    }
+    return volumeLoaded;
+  };
+
+  // Live GPU runs upload the partial scene and splice the volume in mid-run;
+  // batch, bake, and CPU-fallback runs need the finished volume up front
+  const bool deferVolume = !cpuRenderer && batchFrames == 0 &&
+                           bakeScenePath.empty() && !bakedSceneLoaded;
+
+  // Offline bake: write the converted scene (prepareForRender output with
+  // resolved material indices) and exit
+  if (!bakeScenePath.empty()) {
+    finishVolumeLoad();
+    bool ok = SceneFile::write(bakeScenePath, gpuSpheres, gpuEllipsoids,
+                               gpuMaterials, gpuLights, gpuVolumes);
+    if (!cpuRenderer) {
+      vulkanRenderer.shutdown();
+    }
+    if (window)
+      SDL_DestroyWindow(window);
+    SDL_Quit();
+    return ok ? 0 : 1;
+  }
+
+  if (cpuRenderer) {
+    // CPU fallback keeps its own scene copy; the volume is re-read from the
+    // flat .dat/.raw files since there is no GPU density atlas to share
+    finishVolumeLoad();
+    cpuRenderer->setScene(gpuSpheres, gpuEllipsoids, gpuMaterials, gpuLights);
+    if (volumeLoaded && !volumes.empty()) {
+      cpuRenderer->addVolume(datPath, rawPath, volumes[0].getPosition(),
+                             volumes[0].getScale(),
+                             volumes[0].getMaterialIndex());
+    }
+    volumeFile.close();
+  } else if (deferVolume) {
+    // Partial-scene upload: everything except the volume goes up now so the
+    // first frame presents while the read is still in flight; the loop
+    // splices the volume in when the future lands
+    vulkanRenderer.updateScene(gpuSpheres, gpuEllipsoids, gpuMaterials,
+                               gpuLights, std::vector<GPUVolumetricData>(),
+                               std::vector<uint8_t>(), gpuTriangles);
+
+    std::cout << "Scene data uploaded to GPU (volume still streaming)"
+              << std::endl;
+  } else {
+    // Update scene in GPU
+    finishVolumeLoad();
+    vulkanRenderer.updateScene(gpuSpheres, gpuEllipsoids, gpuMaterials,
+                               gpuLights, gpuVolumes, volumeData,
+                               gpuTriangles);
+
+    // Bricked path: volumeData stayed empty above, so updateScene skipped the
+    // density upload; stream the occupied bricks from the mapping instead
+    if (volumeFile.isOpen()) {
+      vulkanRenderer.updateVoxelData(volumeFile);
+      volumeFile.close();
+    }
+
+    std::cout << "Scene data uploaded to GPU" << std::endl;
+  }
 
-  std::cout << "Scene data uploaded to GPU" << std::endl;
+  // Register the ellipsoid spin as a GPU animation pre-pass keyed off
+  // pushConst.time (milliseconds); the rate matches the old CPU loop's
+  // 1/180 rad per frame at the 120 fps cap. After this the render loop
+  // never re-uploads ellipsoids or rebuilds the BVH.
+  if (!cpuRenderer && !gpuEllipsoids.empty()) {
+    std::vector<GPUAnimation> spinAnimations(
+        gpuEllipsoids.size(),
+        {glm::vec4(2.0f, 1.0f, 0.0f, (1.0f / 180.0f) / (1000.0f / 120.0f))});
+    vulkanRenderer.setEllipsoidAnimations(spinAnimations);
+  }
 
   // Prepare static push constants
   PushConstants pushConst{};
   pushConst.numSpheres = static_cast<int>(gpuSpheres.size());
   pushConst.numEllipsoids = static_cast<int>(gpuEllipsoids.size());
   pushConst.numLights = static_cast<int>(gpuLights.size());
-  pushConst.numVolumes = static_cast<int>(gpuVolumes.size());
+  // Deferred volumes enter the push constants at splice time
+  pushConst.numVolumes = deferVolume ? 0 : static_cast<int>(gpuVolumes.size());
   pushConst.maxDepth = MAX_DEPTH;
   pushConst.bgColorBottom = glm::vec3(1.0f, 1.0f, 1.0f); // White
   pushConst.bgColorTop = glm::vec3(0.4f, 0.45f, 1.0f);   // Sky blue
 
+  const double orbitRadius = 3.0;
+  const glm::vec3 lookCenter(2.0f, 1.5f, 0.0f);
+
+  // Shared per-frame update: orbit the camera, spin the ellipsoids, and fill
+  // in the dynamic push constants
+  auto advanceScene = [&](double theta, float time) {
+    double x = 2.0 + orbitRadius * std::cos(theta);
+    double z = 6.0 + orbitRadius * std::sin(theta);
+    camera.setLookFrom(Vec3(x, 1.5, z));
+
+    // The Vulkan path spins the ellipsoids in a GPU pre-pass keyed off
+    // pushConst.time; only the CPU engine still rotates and re-uploads here.
+    // Baked scenes can carry a different ellipsoid count than the built-in
+    // wrappers; only the overlapping range animates.
+    if (cpuRenderer) {
+      for (size_t i = 0; i < ellipsoids.size() && i < gpuEllipsoids.size();
+           i++) {
+        ellipsoids[i].setRotation(
+            quaternionToGlm(Quaternion::fromAxisAngle(Vec3(2, 1, 0), theta)));
+        gpuEllipsoids[i] = ellipsoids[i].toGPU();
+      }
+      cpuRenderer->updateEllipsoids(gpuEllipsoids);
+    }
+
+    glm::vec3 eye(camera.origin.x, camera.origin.y, camera.origin.z);
+    glm::mat4 view = glm::lookAt(eye, lookCenter, glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 proj = glm::perspective(
+        glm::radians(60.0f), static_cast<float>(aspectRatio), 0.1f, 100.0f);
+    pushConst.cameraMatrix = proj * view;
+    pushConst.cameraPos = eye;
+    pushConst.time = time;
+  };
+
+  if (batchFrames > 0) {
+    // Headless batch render: dispatch frames back-to-back without present,
+    // read back through the renderer's alternating host-visible buffers, and
+    // stream PPMs from a writer thread so disk IO never stalls the GPU
+    if (!cpuRenderer) {
+      vulkanRenderer.enableReadback();
+    }
+    std::filesystem::create_directories(batchOutDir);
+
+    std::deque<std::pair<int, std::vector<uint8_t>>> writeQueue;
+    std::mutex queueMutex;
+    std::condition_variable queueCV;
+    bool doneSubmitting = false;
+
+    std::thread writer([&]() {
+      const int width = WINDOW_WIDTH;
+      const int height = WINDOW_HEIGHT;
+      std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3);
+
+      while (true) {
+        std::pair<int, std::vector<uint8_t>> job;
+        {
+          std::unique_lock<std::mutex> lock(queueMutex);
+          queueCV.wait(lock,
+                       [&] { return !writeQueue.empty() || doneSubmitting; });
+          if (writeQueue.empty()) {
+            break;
+          }
+          job = std::move(writeQueue.front());
+          writeQueue.pop_front();
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), "/frame_%05d.ppm", job.first);
+        std::ofstream out(batchOutDir + name, std::ios::binary);
+        if (!out.is_open()) {
+          std::cerr << "Failed to open output file for frame " << job.first
+                    << std::endl;
+          continue;
+        }
+
+        // Drop alpha: readback is RGBA8, PPM wants packed RGB
+        const std::vector<uint8_t> &rgba = job.second;
+        for (size_t p = 0, q = 0; p < rgba.size(); p += 4, q += 3) {
+          rgb[q] = rgba[p];
+          rgb[q + 1] = rgba[p + 1];
+          rgb[q + 2] = rgba[p + 2];
+        }
+
+        out << "P6\n" << width << " " << height << "\n255\n";
+        out.write(reinterpret_cast<const char *>(rgb.data()),
+                  static_cast<std::streamsize>(rgb.size()));
+      }
+    });
+
+    auto enqueueFrame = [&](int index, std::vector<uint8_t> &&pixels) {
+      {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        writeQueue.emplace_back(index, std::move(pixels));
+      }
+      queueCV.notify_one();
+    };
+
+    double batchTheta = 0.0;
+    std::vector<uint8_t> pixels;
+    for (int frame = 0; frame < batchFrames; frame++) {
+      advanceScene(batchTheta, static_cast<float>(frame) * (1000.0f / 120.0f));
+      batchTheta += 1.0 / 180.0;
+
+      if (cpuRenderer) {
+        // CPU frames are synchronous; hand each straight to the writer
+        cpuRenderer->render(camera, pushConst, pixels);
+        enqueueFrame(frame, std::move(pixels));
+        pixels = std::vector<uint8_t>();
+        continue;
+      }
+
+      vulkanRenderer.render(pushConst);
+
+      // Frame N-1's readback is complete (or nearly) while N renders
+      if (vulkanRenderer.fetchPreviousFrame(pixels)) {
+        enqueueFrame(frame - 1, std::move(pixels));
+        pixels = std::vector<uint8_t>();
+      }
+    }
+
+    // Drain the final in-flight frame
+    if (!cpuRenderer && vulkanRenderer.fetchLastFrame(pixels)) {
+      enqueueFrame(batchFrames - 1, std::move(pixels));
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      doneSubmitting = true;
+    }
+    queueCV.notify_one();
+    writer.join();
+
+    std::cout << "Batch render complete: " << batchFrames << " frames written"
+              << std::endl;
+
+    if (!cpuRenderer) {
+      vulkanRenderer.shutdown();
+    }
+    SDL_Quit();
+    return 0;
+  }
+
+  // Interactive runs get live surface-shader editing: edits to
+  // shaders/surface_shaders recompile in the background and swap in between
+  // frames, without restarting (and re-uploading the volume)
+  if (!cpuRenderer) {
+    vulkanRenderer.enableShaderHotReload();
+    if (dynamicResMs > 0.0) {
+      vulkanRenderer.enableDynamicResolution(dynamicResMs);
+    }
+  }
+
   bool running = true;
   SDL_Event event;
 
   double theta = 0.0;
-  const double orbitRadius = 3.0;
   float time = 0.0f;
   int frameCount = 0;
+  std::vector<uint8_t> cpuPixels; // Reused frame buffer for the CPU engine
 
   // Delta time calculation
   uint64_t lastFrameTime = SDL_GetTicksNS();
-  const float targetFrameTime = 1000.0f / 120.0f; // 8.33ms per frame
+  const uint64_t targetFrameTimeNS = 1000000000ull / 120; // 8.333... ms
 
   while (running) {
     // Calculate delta time
@@ -336,57 +721,69 @@ int main(int argc, char *argv[]) {
       }
     }
 
-    // Orbit camera around the volume center and compute camera rotation
-    double x = 2.0 + orbitRadius * std::cos(theta);
-    double z = 6.0 + orbitRadius * std::sin(theta);
-    Vec3 newCameraPos(x, 1.5, z);
+    // Splice the volume in once the background read lands: upload the
+    // record, then the density (bricked stream or flat), and trace it from
+    // the next frame. Until then the partial scene keeps presenting.
+    if (deferVolume && volumeLoadFuture.valid() &&
+        volumeLoadFuture.wait_for(std::chrono::seconds(0)) ==
+            std::future_status::ready) {
+      if (finishVolumeLoad()) {
+        vulkanRenderer.updateVolumes(gpuVolumes);
+        if (volumeFile.isOpen()) {
+          vulkanRenderer.updateVoxelData(volumeFile);
+          volumeFile.close();
+        } else {
+          vulkanRenderer.updateVoxelData(volumeData);
+          volumeData.clear();
+          volumeData.shrink_to_fit();
+        }
+        pushConst.numVolumes = static_cast<int>(gpuVolumes.size());
+      }
+    }
 
-    camera.setLookFrom(newCameraPos);
+    // Orbit camera around the volume center, spin ellipsoids, refresh push
+    // constants
+    advanceScene(theta, time);
     theta += 1.0 / 180.0;
 
-    // Create camera rotation from the orbital angle
-    // The camera orbits around Y-axis at speed theta
-    Quaternion cameraRotation = Quaternion::fromAxisAngle(Vec3(0, 1, 0), theta);
+    if (cpuRenderer) {
+      cpuRenderer->render(camera, pushConst, cpuPixels);
+
+      // Software present: blit the RGBA8 frame onto the window surface
+      if (window) {
+        SDL_Surface *windowSurface = SDL_GetWindowSurface(window);
+        if (windowSurface) {
+          SDL_Surface *frameSurface = SDL_CreateSurfaceFrom(
+              WINDOW_WIDTH, WINDOW_HEIGHT, SDL_PIXELFORMAT_RGBA32,
+              cpuPixels.data(), WINDOW_WIDTH * 4);
+          if (frameSurface) {
+            SDL_BlitSurface(frameSurface, nullptr, windowSurface, nullptr);
+            SDL_DestroySurface(frameSurface);
+          }
+          SDL_UpdateWindowSurface(window);
+        }
+      }
+    } else {
+      vulkanRenderer.render(pushConst);
 
-    // Apply the same rotation to all ellipsoids
-    for (size_t i = 0; i < ellipsoids.size(); i++) {
-      ellipsoids[i].setRotation(
-          quaternionToGlm(Quaternion::fromAxisAngle(Vec3(2, 1, 0), theta)));
-      gpuEllipsoids[i] = ellipsoids[i].toGPU();
+      vulkanRenderer.present();
     }
 
-    // Update scene with rotated ellipsoids
-    vulkanRenderer.updateScene(gpuSpheres, gpuEllipsoids, gpuMaterials,
-                               gpuLights, gpuVolumes, volumeData);
-
-    // Update only dynamic push constants
-    glm::vec3 eye(camera.origin.x, camera.origin.y, camera.origin.z);
-    glm::vec3 center(2.0f, 1.5f, 0.0f);
-    glm::vec3 up(0.0f, 1.0f, 0.0f);
-
-    glm::mat4 view = glm::lookAt(eye, center, up);
-    glm::mat4 proj = glm::perspective(
-        glm::radians(60.0f), static_cast<float>(aspectRatio), 0.1f, 100.0f);
-    pushConst.cameraMatrix = proj * view;
-    pushConst.cameraPos = eye;
-    pushConst.time = time;
-
-    vulkanRenderer.render(pushConst);
-
-    vulkanRenderer.present();
-
     frameCount++;
     time += deltaTime;
 
-    // Cap frame rate
-    if (deltaTime < targetFrameTime) {
-      uint32_t delayMs = static_cast<uint32_t>(targetFrameTime - deltaTime);
-      SDL_Delay(delayMs);
+    // Cap frame rate with nanosecond precision; the old integer-millisecond
+    // SDL_Delay rounded the 8.33 ms budget down and overshot the target
+    uint64_t frameElapsedNS = SDL_GetTicksNS() - currentTime;
+    if (frameElapsedNS < targetFrameTimeNS) {
+      SDL_DelayNS(targetFrameTimeNS - frameElapsedNS);
     }
   }
 
   // Cleanup
-  vulkanRenderer.shutdown();
+  if (!cpuRenderer) {
+    vulkanRenderer.shutdown();
+  }
   if (window)
     SDL_DestroyWindow(window);
   SDL_Quit();